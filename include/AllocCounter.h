@@ -0,0 +1,27 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief 调试用的堆分配计数
+ *
+ * 定义 AMAZONS_COUNT_ALLOCS 时 (CMake 的 Debug 构建) 替换全局 operator new，
+ * 每次分配累加一个原子计数；其它构建中不做任何替换，allocations() 恒为 0。
+ * 用于验证搜索热路径不做堆分配 (见 SearchResult::allocations)。
+ */
+namespace AllocCounter {
+
+/**
+ * @brief 是否编译了计数
+ */
+bool enabled();
+
+/**
+ * @brief 进程启动以来 (所有线程) 的 operator new 调用次数
+ */
+uint64_t allocations();
+
+} // namespace AllocCounter
+
+#endif // ALLOCCOUNTER_H
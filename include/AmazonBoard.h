@@ -5,21 +5,12 @@
 #include <QVector>
 #include <QVariant>
 #include <QDateTime>
+#include "Point.h"
+#include "Position.h"
+#include "UndoLog.h"
 
 // --- 基础数据结构 ---
 
-/**
- * @brief 坐标结构
- */
-struct Point {
-    int col;
-    int row;
-
-    bool operator==(const Point& other) const {
-        return col == other.col && row == other.row;
-    }
-};
-
 /**
  * @brief 棋子结构
  */
@@ -40,7 +31,7 @@ struct MoveRecord {
 };
 
 /**
- * @brief 历史快照结构 (用于悔棋 history)
+ * @brief 旧版存档中的整盘快照 (仅用于读取旧存档，读入后转换为 UndoLog)
  */
 struct GameSnapshot {
     QVector<Piece> pieces;
@@ -69,9 +60,22 @@ public:
 
     // 操作记录与历史
     QVector<MoveRecord> moves;
-    QVector<GameSnapshot> history;
+    UndoLog history;       // 悔棋/重做日志 (每回合一条增量记录)
+
+    // --- 与位棋盘局面互相转换 (规则与 AI 只在 Position 上运行) ---
+
+    /**
+     * @brief 由稀疏列表构建位棋盘局面 (越界坐标会被忽略)
+     */
+    Position toPosition() const;
+
+    /**
+     * @brief 用位棋盘局面覆盖 pieces / blocks / currentPlayer
+     * 已有 blocks 的顺序会被保留，新增的箭按格子索引追加在末尾。
+     */
+    void applyPosition(const Position& pos);
 
-    // 常用逻辑辅助函数
+    // 常用逻辑辅助函数 (仅供 UI 使用)
     bool isOutOfBounds(int col, int row) const {
         return col < 0 || col >= 8 || row < 0 || row >= 8;
     }
@@ -10,6 +10,10 @@
 #include <QDebug>
 #include "AmazonBoard.h"
 #include "GameLogic.h"
+#include "BinarySave.h"
+#include "MappedFile.h"
+#include "GameJournal.h"
+#include "Regions.h"
 
 struct MoveResult {
     bool success;
@@ -24,24 +28,68 @@ public:
     // 暴露给外部（如 MainWindow）调用的接口
     MoveResult movePiece(Point from, Point to);
     MoveResult placeArrow(Point target);
+
+    // 悔棋/重做：基于增量日志，均为 O(1)；未射箭的走子撤销后不可重做
     bool undo();
+    bool redo();
+    bool canRedo() const { return currentBoard.history.canRedo(); }
+
+    /**
+     * @brief 跳转到第 n 个完整回合之后的局面 (0 为开局)，之后的回合仍可重做
+     */
+    bool jumpToPly(int n);
+    int currentPly() const { return currentBoard.history.ply(); }
+    int plyCount() const { return currentBoard.history.completedPlies(); }
     
     // 获取当前棋盘状态用于渲染
     const AmazonBoard& getBoard() const { return currentBoard; }
     
+    // 获取当前位棋盘局面 (规则判定与 AI 使用)
+    const Position& getPosition() const { return position; }
+
+    // 当前局面的空格区域划分 (随走子/射箭增量更新)
+    const RegionMap& getRegions() const { return regions; }
+    
+    /**
+     * @brief 设置对局日志 (可为 nullptr)：成功的走子、射箭、悔棋、重做与跳转都会追加到日志
+     */
+    void setJournal(GameJournal* j) { journal = j; }
+
+    /**
+     * @brief 在当前盘面上重放日志条目 (不会再次写入日志)，遇到无法执行的条目即停止
+     * @return 成功重放的条目数
+     */
+    int replay(const std::vector<JournalEntry>& entries);
+
     // 从外部设置棋盘（用于读档）
-    void setBoard(const AmazonBoard& board) { currentBoard = board; }
+    void setBoard(const AmazonBoard& board) {
+        currentBoard = board;
+        position = currentBoard.toPosition();
+        currentBoard.history.rebuild(position);
+        regions.reset(position);
+    }
 
 private:
-    AmazonBoard currentBoard;
+    int switchTurn();
+    int decidedWinner() const;
+    void movePieceEntry(Point from, Point to);
+    void removeBlock(Point target);
+
+    AmazonBoard currentBoard; // UI 与存档使用的稀疏列表表示
+    Position position;        // 权威的位棋盘局面
+    RegionMap regions;        // 与 position 同步
+    GameJournal* journal = nullptr;
 };
 
 class AmazonPersistence {
 public:
     /**
-     * @brief 将 AmazonBoard 对象保存为本地 JSON 文件
+     * @brief 将 AmazonBoard 对象保存为本地文件
+     * 扩展名为 .amzb 时使用二进制格式 (见 BinarySave.h)，否则为 JSON
      */
     static bool saveBoard(const AmazonBoard& board, const QString& filePath) {
+        if (filePath.endsWith(".amzb", Qt::CaseInsensitive)) return saveBoardBinary(board, filePath);
+
         QJsonObject root;
         root["id"] = board.id;
         root["mode"] = board.mode;
@@ -88,24 +136,13 @@ public:
         }
         root["moves"] = movesArray;
 
-        // 4. 序列化 history (用于悔棋的快照)
+        // 4. 序列化 history (悔棋增量日志，每回合 [from, to, arrow, prior]，格子为索引)
         QJsonArray historyArray;
-        for (const auto& h : board.history) {
-            QJsonObject hObj;
-            hObj["currentPlayer"] = h.currentPlayer;
-            hObj["status"] = h.status;
-            
-            QJsonArray hPieces;
-            for(auto& p : h.pieces) hPieces.append(QJsonObject{{"col", p.col}, {"row", p.row}, {"user", p.user}});
-            hObj["pieces"] = hPieces;
-
-            QJsonArray hBlocks;
-            for(auto& b : h.blocks) hBlocks.append(QJsonObject{{"col", b.col}, {"row", b.row}});
-            hObj["blocks"] = hBlocks;
-
-            historyArray.append(hObj);
+        for (const auto& r : board.history.entries()) {
+            historyArray.append(QJsonArray{r.from, r.to, r.arrow, r.prior});
         }
         root["history"] = historyArray;
+        root["historyPly"] = board.history.ply();
 
         // 写入文件
         QFile file(filePath);
@@ -118,9 +155,14 @@ public:
     }
 
     /**
-     * @brief 从本地 JSON 文件恢复 AmazonBoard 状态
+     * @brief 从本地文件恢复 AmazonBoard 状态 (按文件头自动识别二进制或 JSON 格式)
      */
     static bool loadBoard(AmazonBoard& board, const QString& filePath) {
+        MappedFile mapped;
+        if (mapped.open(filePath.toStdString()) && BinarySave::isBinary(mapped.data(), mapped.size()))
+            return loadBoardBinary(board, mapped.data(), mapped.size());
+        mapped.close();
+
         QFile file(filePath);
         if (!file.open(QIODevice::ReadOnly)) return false;
 
@@ -170,26 +212,158 @@ public:
             board.moves.append(m);
         }
 
-        // 恢复 history (快照)
-        board.history.clear();
+        // 恢复 history：新格式为增量记录；旧格式为整盘快照，读入后转换
+        // 最后与盘面做一致性校验，不一致时丢弃悔棋历史
+        std::vector<PlyRecord> records;
         QJsonArray historyArr = root["history"].toArray();
-        for (auto val : historyArr) {
-            QJsonObject hObj = val.toObject();
-            GameSnapshot s;
-            s.currentPlayer = hObj["currentPlayer"].toInt();
-            s.status = hObj["status"].toString();
-            
-            QJsonArray hP = hObj["pieces"].toArray();
-            for(auto p : hP) s.pieces.append({p.toObject()["col"].toInt(), p.toObject()["row"].toInt(), p.toObject()["user"].toInt()});
-            
-            QJsonArray hB = hObj["blocks"].toArray();
-            for(auto b : hB) s.blocks.append({b.toObject()["col"].toInt(), b.toObject()["row"].toInt()});
-            
-            board.history.append(s);
+        if (!historyArr.isEmpty() && historyArr.first().isObject()) {
+            QVector<GameSnapshot> snapshots;
+            for (auto val : historyArr) {
+                QJsonObject hObj = val.toObject();
+                GameSnapshot s;
+                s.currentPlayer = hObj["currentPlayer"].toInt();
+                s.status = hObj["status"].toString();
+                s.winner = hObj["winner"].isNull() ? QVariant() : QVariant(hObj["winner"].toInt());
+
+                QJsonArray hP = hObj["pieces"].toArray();
+                for(auto p : hP) s.pieces.append({p.toObject()["col"].toInt(), p.toObject()["row"].toInt(), p.toObject()["user"].toInt()});
+
+                QJsonArray hB = hObj["blocks"].toArray();
+                for(auto b : hB) s.blocks.append({b.toObject()["col"].toInt(), b.toObject()["row"].toInt()});
+
+                snapshots.append(s);
+            }
+            records = recordsFromSnapshots(snapshots, board);
+            board.history.assign(records, int(records.size()));
+        } else {
+            for (auto val : historyArr) {
+                QJsonArray r = val.toArray();
+                if (r.size() != 4) { records.clear(); break; }
+                records.push_back({int8_t(r[0].toInt()), int8_t(r[1].toInt()), int8_t(r[2].toInt()), uint8_t(r[3].toInt())});
+            }
+            int ply = root.contains("historyPly") ? root["historyPly"].toInt() : int(records.size());
+            board.history.assign(records, ply);
         }
+        board.history.rebuild(board.toPosition());
 
         return true;
     }
+
+    /**
+     * @brief 存档格式转换 (JSON <-> 二进制)，目标格式由目标文件扩展名决定
+     */
+    static bool convert(const QString& srcPath, const QString& dstPath) {
+        AmazonBoard board;
+        return loadBoard(board, srcPath) && saveBoard(board, dstPath);
+    }
+
+    /**
+     * @brief 以二进制格式保存：头部 + 走子流 + 检查点，单次写入
+     */
+    static bool saveBoardBinary(const AmazonBoard& board, const QString& filePath) {
+        std::vector<uint8_t> buf = encodeBinary(board);
+        QFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+        qint64 written = file.write(reinterpret_cast<const char*>(buf.data()), qint64(buf.size()));
+        file.close();
+        return written == qint64(buf.size());
+    }
+
+    /**
+     * @brief 把对局编码为二进制存档字节 (也用作对局日志的起点快照)
+     */
+    static std::vector<uint8_t> encodeBinary(const AmazonBoard& board) {
+        BinarySave::GameInfo info;
+        info.id = board.id.toStdString();
+        info.mode = board.mode == "pve" ? 1 : 0;
+        info.currentPlayer = uint8_t(board.currentPlayer);
+        info.status = board.status == "finished" ? 1 : 0;
+        info.winner = board.winner.isValid() && !board.winner.isNull() ? int8_t(board.winner.toInt()) : int8_t(-1);
+
+        return BinarySave::encode(info, board.toPosition(), board.history);
+    }
+
+    /**
+     * @brief 直接在内存 (映射文件或日志快照) 上读取二进制存档
+     */
+    static bool loadBoardBinary(AmazonBoard& board, const uint8_t* data, size_t size) {
+        BinarySave::View view;
+        if (!view.open(data, size)) return false;
+        const BinarySave::Header& h = view.header();
+
+        board.id = QString::fromStdString(view.id());
+        board.mode = h.mode ? "pve" : "pvp";
+        board.status = h.status ? "finished" : "playing";
+        board.winner = h.winner >= 0 ? QVariant(int(h.winner)) : QVariant();
+
+        // 障碍顺序：开局已有的障碍在前，其余按走子流中的射箭顺序
+        board.blocks.clear();
+        board.applyPosition(view.positionAt(0));
+        board.moves.clear();
+        const PlyRecord* recs = view.records();
+        for (int i = 0; i < view.cursor(); ++i) {
+            MoveRecord m;
+            m.type = "move";
+            m.from = GameLogic::fromPosKey(recs[i].from);
+            m.to = GameLogic::fromPosKey(recs[i].to);
+            m.ts = 0; // 二进制格式不保存时间戳
+            board.moves.append(m);
+            if (recs[i].complete()) board.blocks.append(GameLogic::fromPosKey(recs[i].arrow));
+        }
+        board.applyPosition(view.current());
+
+        board.history.assign(std::vector<PlyRecord>(recs, recs + view.recordCount()), view.cursor());
+        board.history.rebuild(board.toPosition());
+        return true;
+    }
+
+private:
+    /**
+     * @brief 把旧版的整盘快照序列转换为增量记录
+     *
+     * 相邻两个快照 (最后一个与当前盘面) 的位棋盘差分即为一个回合。旧版在校验走法之前
+     * 就保存快照，无效走子会留下与下一快照相同的重复项，这里直接跳过。
+     * 无法解释的差分说明存档不一致，此时返回空记录 (丢弃悔棋历史)。
+     */
+    static std::vector<PlyRecord> recordsFromSnapshots(const QVector<GameSnapshot>& snapshots, const AmazonBoard& board) {
+        QVector<Position> states;
+        QVector<const GameSnapshot*> priors;
+        for (const auto& s : snapshots) {
+            AmazonBoard tmp;
+            tmp.pieces = s.pieces;
+            tmp.blocks = s.blocks;
+            tmp.currentPlayer = s.currentPlayer;
+            states.append(tmp.toPosition());
+            priors.append(&s);
+        }
+        states.append(board.toPosition());
+
+        std::vector<PlyRecord> records;
+        for (int i = 0; i + 1 < states.size(); ++i) {
+            const Position& a = states[i];
+            const Position& b = states[i + 1];
+            int mover = a.sideToMove;
+            Bitboard fromBB = a.amazons[mover] & ~b.amazons[mover];
+            Bitboard toBB = b.amazons[mover] & ~a.amazons[mover];
+            Bitboard arrowBB = b.arrows & ~a.arrows;
+            if (!fromBB && !toBB && !arrowBB && a.arrows == b.arrows) continue;
+
+            bool last = i + 2 == states.size();
+            bool ok = Bitboards::popCount(fromBB) == 1 && Bitboards::popCount(toBB) == 1
+                   && Bitboards::popCount(arrowBB) <= 1 && (a.arrows & ~b.arrows) == 0
+                   && a.amazons[mover ^ 1] == b.amazons[mover ^ 1]
+                   && (arrowBB || last);
+            if (!ok) return {};
+
+            const GameSnapshot* prior = priors[i];
+            int winner = prior->winner.isValid() && !prior->winner.isNull() ? prior->winner.toInt() : -1;
+            PlyRecord rec = PlyRecord::make(Bitboards::lsb(fromBB), Bitboards::lsb(toBB),
+                                            prior->status == "finished", winner);
+            if (arrowBB) rec.arrow = int8_t(Bitboards::lsb(arrowBB));
+            records.push_back(rec);
+        }
+        return records;
+    }
 };
 
 #endif
\ No newline at end of file
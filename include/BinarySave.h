@@ -0,0 +1,125 @@
+#ifndef BINARYSAVE_H
+#define BINARYSAVE_H
+
+#include "Position.h"
+#include "UndoLog.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 二进制存档格式 (.amzb)，与 JSON 存档并存
+ *
+ * 文件布局 (小端序，各段偏移都可由头部直接算出)：
+ *   [Header 64B][对局 id：idLength 字节，补齐到 8 字节]
+ *   [走子流：plyCount 条 PlyRecord，每条 4 字节，补齐到 8 字节]
+ *   [检查点：checkpointCount 个 Checkpoint，每个 32 字节 (可选)]
+ *
+ * 读取时整体 mmap，View 校验头部、各段边界以及检查点与走子流中的格子取值，不解码局面；
+ * 第 n 回合的局面可从最近的检查点重放得到。
+ */
+namespace BinarySave {
+
+constexpr char MAGIC[4] = {'A', 'M', 'Z', 'B'};
+constexpr uint16_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint8_t mode;               // 0: pvp, 1: pve
+    uint8_t currentPlayer;      // 1: 红方, 0: 蓝方
+    uint8_t status;             // 0: playing, 1: finished
+    int8_t winner;              // -1 表示无
+    uint32_t plyCount;          // 走子流记录数 (含未射箭的最后一回合)
+    uint32_t plyCursor;         // 悔棋游标：已应用的记录数
+    uint32_t idLength;
+    uint32_t checkpointInterval; // 0 表示没有检查点
+    uint32_t checkpointCount;
+    uint64_t amazons[2];        // 游标处的局面，无需重放即可显示
+    uint64_t arrows;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(Header) == 64, "BinarySave::Header must stay 64 bytes");
+
+/**
+ * @brief 第 ply 个完整回合之后的局面 (第 0 个检查点为开局)
+ */
+struct Checkpoint {
+    uint64_t amazons[2];
+    uint64_t arrows;
+    uint32_t ply;
+    uint32_t sideToMove;
+};
+static_assert(sizeof(Checkpoint) == 32, "BinarySave::Checkpoint must stay 32 bytes");
+static_assert(sizeof(PlyRecord) == 4, "PlyRecord is stored verbatim in the move stream");
+
+/**
+ * @brief 存档中除局面与走子流以外的对局信息
+ */
+struct GameInfo {
+    std::string id;
+    uint8_t mode = 0;
+    uint8_t currentPlayer = 1;
+    uint8_t status = 0;
+    int8_t winner = -1;
+};
+
+/**
+ * @brief 把整个存档编码到内存缓冲区，调用方单次写入文件
+ * @param current 悔棋游标处的局面
+ * @param checkpoints 是否写入检查点段
+ */
+std::vector<uint8_t> encode(const GameInfo& info, const Position& current,
+                            const UndoLog& history, bool checkpoints = true);
+
+/**
+ * @brief encode 后直接写入文件 (不依赖 Qt 的调用方使用)
+ */
+bool write(const std::string& path, const GameInfo& info, const Position& current,
+           const UndoLog& history, bool checkpoints = true);
+
+/**
+ * @brief 文件开头是否为二进制存档的魔数
+ */
+bool isBinary(const uint8_t* data, size_t size);
+
+/**
+ * @brief 指向映射内存的只读视图，不复制数据
+ */
+class View {
+public:
+    /**
+     * @brief 校验头部与各段边界
+     */
+    bool open(const uint8_t* data, size_t size);
+
+    const Header& header() const { return *hdr; }
+    std::string id() const;
+    GameInfo info() const;
+
+    const PlyRecord* records() const { return recs; }
+    size_t recordCount() const { return hdr->plyCount; }
+    int cursor() const { return int(hdr->plyCursor); }
+
+    /**
+     * @brief 游标处的局面
+     */
+    Position current() const;
+
+    /**
+     * @brief 第 n 个完整回合之后的局面；有检查点时最多重放 checkpointInterval 条记录
+     */
+    Position positionAt(int n) const;
+
+private:
+    const Header* hdr = nullptr;
+    const char* idBytes = nullptr;
+    const PlyRecord* recs = nullptr;
+    const Checkpoint* checkpoints = nullptr;
+};
+
+} // namespace BinarySave
+
+#endif // BINARYSAVE_H
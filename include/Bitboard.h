@@ -0,0 +1,122 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+// --- 位棋盘 (Bitboard) 基础设施 ---
+// 8x8 棋盘的每个格子对应 64 位整数中的一位，索引为 row * 8 + col
+// (与 GameLogic::getPosKey 保持一致)。
+
+typedef uint64_t Bitboard;
+
+namespace Bitboards {
+
+/**
+ * @brief 方向编号：前 4 个方向索引递增 (正向)，后 4 个方向索引递减 (反向)
+ */
+enum Direction {
+    East = 0,   // col + 1
+    North,      // row + 1
+    NorthEast,  // col + 1, row + 1
+    NorthWest,  // col - 1, row + 1
+    West,       // col - 1
+    South,      // row - 1
+    SouthWest,  // col - 1, row - 1
+    SouthEast,  // col + 1, row - 1
+    DirectionCount
+};
+
+constexpr int squareOf(int col, int row) { return row * 8 + col; }
+constexpr int colOf(int sq) { return sq & 7; }
+constexpr int rowOf(int sq) { return sq >> 3; }
+constexpr Bitboard squareBB(int sq) { return 1ULL << sq; }
+
+constexpr Bitboard FileA = 0x0101010101010101ULL;
+constexpr Bitboard FileH = FileA << 7;
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline int msb(Bitboard b) { return 63 - __builtin_clzll(b); }
+
+/**
+ * @brief 取出并清除最低位，返回其格子索引
+ */
+inline int popLsb(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+namespace detail {
+
+struct RayTables {
+    Bitboard rays[DirectionCount][64];
+    Bitboard king[64];
+    Bitboard betweenBB[64][64];
+    Bitboard beyondBB[64][64];
+};
+
+// 在 Bitboard.cpp 中编译期生成；在此声明以便下面的查询函数内联
+extern const RayTables tables;
+
+} // namespace detail
+
+/**
+ * @brief 从 sq 出发沿 dir 方向的射线 (不含 sq 本身)
+ */
+inline Bitboard ray(int dir, int sq) { return detail::tables.rays[dir][sq]; }
+
+/**
+ * @brief a 与 b 之间 (不含两端) 的格子；若不在同一直线/斜线上返回 0
+ */
+inline Bitboard between(int a, int b) { return detail::tables.betweenBB[a][b]; }
+
+/**
+ * @brief 从 a 经过 b 继续延伸的射线 (不含 b)；若不在同一直线/斜线上返回 0
+ */
+inline Bitboard beyond(int a, int b) { return detail::tables.beyondBB[a][b]; }
+
+/**
+ * @brief 王步邻域 (周围 8 格)
+ */
+inline Bitboard kingAttacks(int sq) { return detail::tables.king[sq]; }
+
+/**
+ * @brief 整体王步扩散：返回 b 中所有格子的 8 邻域并集 (不含 b 自身)
+ */
+inline Bitboard kingSpread(Bitboard b) {
+    Bitboard lr = ((b << 1) & ~FileA) | ((b >> 1) & ~FileH);
+    Bitboard row = b | lr;
+    return (lr | (row << 8) | (row >> 8)) & ~b;
+}
+
+/**
+ * @brief 沿单个方向滑行可到达的格子 (遇到占用格停止，不含占用格)
+ */
+inline Bitboard slideAttacks(int dir, int sq, Bitboard occupied) {
+    // 最近的阻挡点：正向射线取最低位，反向射线取最高位。没有阻挡时取 63 / 0 号格，
+    // 它们在对应方向上的射线为空，因此无需分支
+    Bitboard blockers = ray(dir, sq) & occupied;
+    int b = dir < West ? lsb(blockers | squareBB(63)) : msb(blockers | 1);
+    return (ray(dir, sq) ^ ray(dir, b)) & ~occupied;
+}
+
+/**
+ * @brief 皇后走法 (8 个方向滑行，遇到占用格停止，不含占用格)
+ */
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    Bitboard result = 0;
+    for (int d = East; d <= NorthWest; ++d) {
+        Bitboard blockers = ray(d, sq) & occupied;
+        result |= ray(d, sq) ^ ray(d, lsb(blockers | squareBB(63)));
+    }
+    for (int d = West; d <= SouthEast; ++d) {
+        Bitboard blockers = ray(d, sq) & occupied;
+        result |= ray(d, sq) ^ ray(d, msb(blockers | 1));
+    }
+    return result & ~occupied;
+}
+
+} // namespace Bitboards
+
+#endif // BITBOARD_H
@@ -0,0 +1,28 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "Position.h"
+
+// --- 静态评估 (所有搜索后端共用) ---
+
+namespace Evaluation {
+
+/**
+ * @brief 中心控制权重 (越靠近中心分越高)，按格子索引 row * 8 + col
+ */
+int centerWeight(int sq);
+
+/**
+ * @brief 灵活性与中心控制两项 (IncrementalEval 增量维护的就是这一部分)
+ * 分数单位：1 步灵活性 = 2 分，中心权重 1 分
+ */
+int mobilityScore(const Position& pos, int player);
+
+/**
+ * @brief 从 player 视角评估局面：mobilityScore + 领地评估 (Territory::evaluate)
+ */
+int evaluate(const Position& pos, int player);
+
+} // namespace Evaluation
+
+#endif // EVALUATION_H
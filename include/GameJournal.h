@@ -0,0 +1,139 @@
+#ifndef GAMEJOURNAL_H
+#define GAMEJOURNAL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 日志中记录的操作类型
+ */
+enum class JournalOp : uint8_t {
+    Move = 1,    // a: 起点, b: 落点
+    Arrow = 2,   // a: 箭的格子
+    Undo = 3,
+    Redo = 4,
+    Jump = 5     // a | b << 8: 目标回合
+};
+
+/**
+ * @brief 日志条目 (4 字节)，末字节为校验，用于识别崩溃时写了一半的尾部
+ */
+struct JournalEntry {
+    uint8_t op;
+    uint8_t a;
+    uint8_t b;
+    uint8_t check;
+
+    static JournalEntry make(JournalOp op, int a, int b) {
+        JournalEntry e = {uint8_t(op), uint8_t(a), uint8_t(b), 0};
+        e.check = e.checksum();
+        return e;
+    }
+    uint8_t checksum() const { return uint8_t(op ^ a ^ b ^ 0x5A); }
+    bool valid() const { return check == checksum() && op >= uint8_t(JournalOp::Move) && op <= uint8_t(JournalOp::Jump); }
+    JournalOp type() const { return JournalOp(op); }
+};
+
+/**
+ * @brief 对局日志的持久化策略
+ */
+enum class JournalDurability {
+    None,       // 只写入操作系统缓存，由系统决定何时落盘
+    Batched,    // 写入后至多 syncIntervalMs 毫秒内 fsync 一次 (默认)
+    EveryWrite  // 每批写入后立即 fsync
+};
+
+struct JournalOptions {
+    JournalDurability durability = JournalDurability::Batched;
+    int syncIntervalMs = 200;
+};
+
+/**
+ * @brief 只追加的对局日志 (.amzj)，由后台线程写入
+ *
+ * 文件布局：[16 字节头部][开局快照 (二进制存档，补齐到 4 字节)][JournalEntry ...]
+ * append() 只把 4 字节放进内存队列，与对局长度无关；写文件与 fsync 都在写线程中完成，
+ * 多个条目合并为一次写入。崩溃后用 read() 读取快照与完整的条目，在快照上重放即可恢复。
+ */
+class GameJournal {
+public:
+    GameJournal() = default;
+    ~GameJournal() { close(); }
+
+    GameJournal(const GameJournal&) = delete;
+    GameJournal& operator=(const GameJournal&) = delete;
+
+    /**
+     * @brief 创建日志文件并启动写线程
+     * @param snapshot 日志起点的对局快照 (BinarySave 格式)，头部由写线程写入
+     */
+    bool open(const std::string& path, const std::vector<uint8_t>& snapshot,
+              const JournalOptions& options = JournalOptions());
+
+    /**
+     * @brief 追加一个条目 (O(1)，只入队，不做任何 I/O)
+     */
+    void append(JournalOp op, int a = 0, int b = 0);
+
+    /**
+     * @brief 阻塞直到此前追加的条目全部写出 (并按策略同步到磁盘)
+     */
+    void flush();
+
+    /**
+     * @brief 写完剩余条目后关闭文件 (对局正常结束时文件保留，由调用方决定是否删除)
+     */
+    void close();
+
+    /**
+     * @brief 关闭并删除日志文件
+     */
+    void discard();
+
+    bool isOpen() const { return file != nullptr; }
+    bool failed() const;
+    const std::string& path() const { return filePath; }
+    uint64_t syncCount() const;
+
+    /**
+     * @brief 读取日志：校验头部，返回快照与所有完整且校验通过的条目
+     * 尾部被截断或损坏的条目会被丢弃 (即崩溃前尚未写完的部分)
+     */
+    static bool read(const std::string& path, std::vector<uint8_t>& snapshot, std::vector<JournalEntry>& entries);
+
+private:
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t snapshotSize;
+        uint32_t reserved2;
+    };
+    static_assert(sizeof(Header) == 16, "GameJournal::Header must stay 16 bytes");
+    static_assert(sizeof(JournalEntry) == 4, "JournalEntry must stay 4 bytes");
+
+    void writerLoop();
+
+    std::string filePath;
+    std::FILE* file = nullptr;
+    JournalOptions opts;
+    std::thread writer;
+
+    mutable std::mutex mutex;
+    std::condition_variable wakeWriter;
+    std::condition_variable written;
+    std::vector<uint8_t> pending;       // 待写出的字节
+    uint64_t appendedBytes = 0;         // 已入队的总字节数
+    uint64_t durableBytes = 0;          // 已写出 (并按策略同步) 的总字节数
+    int flushWaiters = 0;
+    bool stopping = false;
+    bool writeFailed = false;
+    uint64_t syncs = 0;
+};
+
+#endif // GAMEJOURNAL_H
@@ -1,22 +1,20 @@
 #ifndef GAMELOGIC_H
 #define GAMELOGIC_H
 
-#include <QVector>
-#include <set>
-#include "AmazonBoard.h"
+#include "Point.h"
+#include "Position.h"
 
 class GameLogic {
 public:
     static bool inBounds(int col, int row);
     static bool isLineMove(Point from, Point to);
-    static bool isPathClear(Point from, Point to, const QVector<Piece>& pieces, const QVector<Point>& blocks);
-    static bool canPlayerMove(int player, const QVector<Piece>& pieces, const QVector<Point>& blocks);
+    static bool isPathClear(Point from, Point to, const Position& pos);
+    static bool canPlayerMove(int player, const Position& pos);
 
-private:
-    // 辅助函数：将坐标转换为唯一索引
+    // 辅助函数：将坐标转换为唯一索引 (即位棋盘格子索引)
     static inline int getPosKey(int c, int r) { return r * 8 + c; }
-    // 获取当前所有被占用的位置集合
-    static std::set<int> getOccupiedPositions(const QVector<Piece>& pieces, const QVector<Point>& blocks);
+    static inline int getPosKey(Point p) { return getPosKey(p.col, p.row); }
+    static inline Point fromPosKey(int key) { return {key % 8, key / 8}; }
 };
 
-#endif // GAMELOGIC_H
\ No newline at end of file
+#endif // GAMELOGIC_H
@@ -0,0 +1,116 @@
+#ifndef INCREMENTALEVAL_H
+#define INCREMENTALEVAL_H
+
+#include "Position.h"
+
+/**
+ * @brief 随走子/撤销增量维护的灵活性评估，结果与 Evaluation::mobilityScore 完全一致
+ *
+ * 维护每个亚马逊可到达的格子 (即其灵活性)、每方对每个格子的到达计数以及双方的中心权重和。
+ * 一个格子的占用状态改变时，只有经过该格子的射线需要更新：能到达该格子的亚马逊失去
+ * 它之后的那一段，射线止于该格子的亚马逊则向后延伸；移动的亚马逊本身在起点撤掉、在落点重算。
+ * 叶子评估只读两方的合计，O(1)。
+ *
+ * 整个状态是约 200 字节的 POD：makeMove 先把它压栈再增量更新，unmakeMove 直接弹栈恢复，
+ * 因此撤销是逐位精确的。撤销栈是定长数组 (与搜索的最大层数一致)，走子不做堆分配。底层的 moveAmazon / placeArrow / removeArrow 不压栈，
+ * 反向调用即可撤销 (用于射箭枚举)。与 Position 一样不做合法性校验。
+ */
+class IncrementalEval {
+public:
+    // 8x8 变体每方 4 个亚马逊
+    static constexpr int MAX_PIECES = 8;
+    // 撤销栈深度，与 SearchEngine::MAX_PLY 一致
+    static constexpr int MAX_DEPTH = 64;
+
+    IncrementalEval() { reset(Position()); }
+    explicit IncrementalEval(const Position& pos) { reset(pos); }
+
+    /**
+     * @brief 从头计算 (根节点或局面被直接修改后调用)，同时清空撤销栈
+     */
+    void reset(const Position& pos);
+
+    // --- 与 Position 对应的底层修改 ---
+    void moveAmazon(int player, int from, int to);
+    void placeArrow(int sq);
+    void removeArrow(int sq);
+
+    /**
+     * @brief 执行一个完整回合 (走子、射箭、换手)
+     */
+    void makeMove(const Move& m) {
+        undoStack[depth++] = st;
+        moveAmazon(st.sideToMove, m.from, m.to);
+        placeArrow(m.arrow);
+        st.sideToMove ^= 1;
+    }
+
+    /**
+     * @brief 撤销最近一次 makeMove
+     */
+    void unmakeMove(const Move&) {
+        st = undoStack[--depth];
+    }
+
+    /**
+     * @brief 从 player 视角的评估，与 Evaluation::mobilityScore(pos, player) 相同
+     */
+    int evaluate(int player) const {
+        int opp = player ^ 1;
+        return 2 * (st.mobility[player] - st.mobility[opp]) + st.center[player] - st.center[opp];
+    }
+
+    int totalMobility(int player) const { return st.mobility[player]; }
+
+    /**
+     * @brief sq 上亚马逊可到达的格子 (sq 上没有亚马逊时为 0)
+     */
+    Bitboard pieceAttacks(int sq) const {
+        for (int i = 0; i < st.count; ++i)
+            if (st.square[i] == sq) return st.attacks[i];
+        return 0;
+    }
+    int pieceMobility(int sq) const { return Bitboards::popCount(pieceAttacks(sq)); }
+
+    /**
+     * @brief player 一方能一步走到 sq 的亚马逊个数
+     */
+    int reachCount(int player, int sq) const {
+        const Bitboard* r = st.reach[player];
+        return int((r[0] >> sq) & 1) | int((r[1] >> sq) & 1) << 1 | int((r[2] >> sq) & 1) << 2;
+    }
+
+    /**
+     * @brief 与从头计算的结果逐项比较 (调试用)
+     */
+    bool matches(const Position& pos) const;
+
+private:
+    // 给第 i 个亚马逊加上/去掉 span 中的格子
+    void add(int i, Bitboard span);
+    void remove(int i, Bitboard span);
+    // 格子 sq 变空 / 被占时，更新经过 sq 的其它亚马逊的射线
+    void vacate(int sq);
+    void block(int sq);
+
+    struct State {
+        Bitboard amazons[2];
+        Bitboard occupied;
+        Bitboard attacks[MAX_PIECES];   // 第 i 个亚马逊可到达的格子
+        // 到达计数按位切片保存 (每方至多 7 个亚马逊，3 位足够)：
+        // 第 k 个位棋盘是每个格子计数的第 k 位，整段射线的加减只需几次位运算
+        Bitboard reach[2][3];
+        int8_t square[MAX_PIECES];
+        int8_t owner[MAX_PIECES];
+        int count;
+        int sideToMove;
+        int mobility[2];
+        int center[2];
+    };
+
+    State st;
+    State undoStack[MAX_DEPTH];
+    int depth = 0;
+};
+
+#endif // INCREMENTALEVAL_H
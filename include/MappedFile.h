@@ -0,0 +1,40 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 只读内存映射文件 (POSIX mmap / Win32 MapViewOfFile)
+ *
+ * 映射期间文件内容按需由操作系统分页读入，调用方直接在 data() 上解析，
+ * 不需要把整个文件读进缓冲区。路径为 UTF-8。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief 映射整个文件 (空文件或打开失败返回 false)
+     */
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    const uint8_t* data() const { return static_cast<const uint8_t*>(base); }
+    size_t size() const { return length; }
+
+private:
+    void* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
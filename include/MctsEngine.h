@@ -0,0 +1,131 @@
+#ifndef MCTSENGINE_H
+#define MCTSENGINE_H
+
+#include "Position.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+class MoveOrdering;
+namespace Tablebase { class View; }
+
+/**
+ * @brief MCTS 搜索统计
+ */
+struct MctsStats {
+    uint64_t playouts = 0;
+    uint64_t treeNodes = 0;     // 竞技场中已分配的节点数
+    int elapsedMs = 0;
+
+    double playoutsPerSecond() const {
+        return elapsedMs > 0 ? playouts * 1000.0 / elapsedMs : 0.0;
+    }
+};
+
+/**
+ * @brief 蒙特卡洛树搜索 (UCT) 后端
+ *
+ * 一个完整回合被拆成两层动作：先选走子 (from→to)，再选射箭格子，两层都按
+ * 启发式先验排序并做渐进展宽 (progressive widening)。节点全部分配在预先申请的
+ * 竞技场 (arena) 中，搜索过程中不做堆分配。多个工作线程共享同一棵树，
+ * 下行时先累加访问次数作为虚拟损失 (virtual loss)，使并行线程分散到不同分支。
+ */
+class MctsEngine {
+public:
+    explicit MctsEngine(size_t maxNodes = DEFAULT_ARENA_NODES);
+
+    static const size_t DEFAULT_ARENA_NODES = 1 << 21;
+
+    /**
+     * @brief 搜索并返回 player 的最佳完整走法
+     * @param timeMs 时间上限 (0 表示不限)
+     * @param maxPlayouts 模拟次数上限 (0 表示不限)
+     * @param threads 工作线程数
+     * @param cancel 外部取消标志 (可选)
+     * @param ponder 后台思考标志 (可选)，置位期间忽略 timeMs
+     */
+    Move search(const Position& pos, int player, int timeMs, uint64_t maxPlayouts, int threads,
+                const std::atomic<bool>* cancel = nullptr, const std::atomic<bool>* ponder = nullptr);
+
+    /**
+     * @brief 请求正在进行的搜索尽快结束 (可从其他线程调用)
+     */
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); }
+
+    void setSeed(uint64_t s) { seed = s ? s : 1; }
+
+    /**
+     * @brief 进度回调，由 0 号工作线程约每 100ms 调用一次
+     */
+    void setProgressCallback(std::function<void(const MctsStats&)> cb) { progressCallback = std::move(cb); }
+
+    void setArenaSize(size_t maxNodes);
+
+    /**
+     * @brief 走法排序表 (可选)：其历史分叠加到走子/射箭先验上。搜索期间只读
+     */
+    void setOrdering(const MoveOrdering* o) { ordering = o; }
+
+    /**
+     * @brief 孤立区域残局库 (可选)，用于模拟结束时判定已分隔的局面
+     */
+    void setTablebase(const Tablebase::View* tb) { tablebase = tb; }
+
+    const MctsStats& lastStats() const { return stats; }
+
+private:
+    struct Node {
+        std::atomic<uint32_t> visits{0};      // 含正在进行中的访问 (虚拟损失)
+        std::atomic<uint32_t> firstChild{0};
+        std::atomic<uint64_t> value{0};       // 定点累积胜率 (单位 1/VALUE_SCALE)
+        std::atomic<uint8_t> state{0};        // 0 未展开, 1 展开中, 2 已展开
+        uint16_t childCount = 0;
+        int8_t from = -1;                     // 走子层：from/to；射箭层：to 为箭的格子
+        int8_t to = -1;
+        uint8_t player = 0;                   // 做出到达该节点动作的一方
+        bool arrowLevel = false;              // 该节点的子节点是否为射箭动作
+    };
+
+    struct Rng {
+        uint64_t s;
+        uint64_t next() {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return s;
+        }
+        int bounded(int n) { return int((next() >> 32) * uint64_t(n) >> 32); }
+    };
+
+    static const int VALUE_SCALE = 1024;
+    static const int MAX_DEPTH = 192;
+
+    void worker(int id, const Position& root);
+    bool expand(uint32_t idx, const Position& pos, int pendingFrom);
+    uint32_t selectChild(const Node& node) const;
+    double playout(Position pos, int pendingTo, Rng& rng) const;
+    Move bestMove(const Position& root) const;
+    uint32_t allocate(uint32_t count);
+
+    static int randomSquare(Bitboard b, Rng& rng);
+
+    std::unique_ptr<Node[]> nodes;
+    size_t capacity = 0;
+    std::atomic<uint32_t> used{0};
+
+    std::atomic<bool> stopFlag{false};
+    const std::atomic<bool>* cancelFlag = nullptr;
+    const std::atomic<bool>* ponderFlag = nullptr;
+    std::function<void(const MctsStats&)> progressCallback;
+    const MoveOrdering* ordering = nullptr;
+    const Tablebase::View* tablebase = nullptr;
+    std::atomic<uint64_t> playouts{0};
+    uint64_t playoutLimit = 0;
+    int timeLimitMs = 0;
+    int64_t startMs = 0;
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    MctsStats stats;
+};
+
+#endif // MCTSENGINE_H
@@ -0,0 +1,47 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include "Position.h"
+
+/**
+ * @brief 带排序分的完整走法
+ */
+struct ScoredMove {
+    Move move;
+    int score;
+};
+
+/**
+ * @brief 定长走法列表，不做任何堆分配
+ *
+ * 8x8 棋盘上一个格子的皇后走法最多 27 个，因此一方 4 个亚马逊的完整走法
+ * (走子 × 射箭) 不超过 4 * 27 * 27 个。超出容量的走法会被丢弃。
+ */
+class MoveList {
+public:
+    static constexpr int MAX_PIECES = 4;
+    static constexpr int MAX_QUEEN_MOVES = 27;
+    static constexpr int CAPACITY = MAX_PIECES * MAX_QUEEN_MOVES * MAX_QUEEN_MOVES;
+
+    void clear() { count = 0; }
+    void push(const Move& m, int score) {
+        if (count < CAPACITY) moves[count++] = {m, score};
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    ScoredMove& operator[](int i) { return moves[i]; }
+    const ScoredMove& operator[](int i) const { return moves[i]; }
+
+    ScoredMove* begin() { return moves; }
+    ScoredMove* end() { return moves + count; }
+    const ScoredMove* begin() const { return moves; }
+    const ScoredMove* end() const { return moves + count; }
+
+private:
+    int count = 0;
+    ScoredMove moves[CAPACITY];
+};
+
+#endif // MOVELIST_H
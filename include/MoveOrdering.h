@@ -0,0 +1,88 @@
+#ifndef MOVEORDERING_H
+#define MOVEORDERING_H
+
+#include "MovePicker.h"
+#include <cstdint>
+
+/**
+ * @brief 走法排序效果的统计
+ */
+struct OrderingStats {
+    uint64_t interiorNodes = 0;     // 展开过子节点的内部节点
+    uint64_t movesSearched = 0;     // 这些节点实际搜索的子走法总数
+    uint64_t cutoffs = 0;           // 发生 beta 截断的节点
+    uint64_t firstMoveCutoffs = 0;  // 其中由第一个走法截断的节点
+
+    /**
+     * @brief 平均每个内部节点搜索的子走法数 (有效分支因子)
+     */
+    double branchingFactor() const { return interiorNodes ? double(movesSearched) / double(interiorNodes) : 0.0; }
+
+    /**
+     * @brief 截断发生在第一个走法上的比例，越接近 1 排序越好
+     */
+    double firstMoveCutoffRate() const { return cutoffs ? double(firstMoveCutoffs) / double(cutoffs) : 0.0; }
+
+    OrderingStats& operator+=(const OrderingStats& o) {
+        interiorNodes += o.interiorNodes;
+        movesSearched += o.movesSearched;
+        cutoffs += o.cutoffs;
+        firstMoveCutoffs += o.firstMoveCutoffs;
+        return *this;
+    }
+};
+
+/**
+ * @brief 走法排序：走子 (from→to) 与射箭格子各有一张历史表，另有每层两个杀手走法
+ *
+ * 历史分在截断时按深度平方奖励截断走法、惩罚此前搜索过的走法 (带衰减的 "gravity"
+ * 更新，绝对值不超过 HISTORY_MAX)。两阶段的排序分都是 DefaultMoveScorer 的启发分
+ * 加上对应的历史分，因此表为空时与默认排序一致。每回合开始时调用 newSearch 让历史
+ * 减半、清空杀手，使上一回合学到的次序延续但不固化。
+ *
+ * Alpha-Beta 每个线程持有一份 (无需同步)；MCTS 与束搜索读取主线程那一份作为先验。
+ */
+class MoveOrdering : public MoveScorer {
+public:
+    static constexpr int MAX_PLY = 64;
+    static constexpr int HISTORY_MAX = 1 << 14;
+    // 默认启发分相对历史分的放大倍数
+    static constexpr int BASE_SCALE = 64;
+
+    MoveOrdering() { clear(); }
+
+    void clear();
+
+    /**
+     * @brief 新一回合：历史分减半，清空杀手
+     */
+    void newSearch();
+
+    int queenScore(const Position& pos, int from, int to) const override;
+    int arrowScore(const Position& pos, int from, int to, int arrow) const override;
+
+    int queenHistory(int side, int from, int to) const { return queen[side][from][to]; }
+    int arrowHistory(int side, int arrow) const { return arrows[side][arrow]; }
+
+    /**
+     * @brief 第 ply 层的杀手走法 (MovePicker::MAX_KILLERS 个，可能为 Move::none())
+     */
+    const Move* killers(int ply) const { return killerMoves[ply]; }
+
+    /**
+     * @brief 记录一次 beta 截断
+     * @param side 走子方
+     * @param best 造成截断的走法
+     * @param tried 在它之前搜索过、未能截断的走法
+     */
+    void onCutoff(int side, int ply, int depth, const Move& best, const Move* tried, int triedCount);
+
+private:
+    static void gravity(int16_t& entry, int bonus);
+
+    int16_t queen[2][64][64];
+    int16_t arrows[2][64];
+    Move killerMoves[MAX_PLY][MovePicker::MAX_KILLERS];
+};
+
+#endif // MOVEORDERING_H
@@ -0,0 +1,103 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "Position.h"
+
+/**
+ * @brief 走法排序策略：分别给走子 (from→to) 与射箭打分，分高者先搜
+ *
+ * MovePicker 只在真正展开某一阶段时才调用对应的打分函数。
+ */
+class MoveScorer {
+public:
+    virtual ~MoveScorer() = default;
+
+    /**
+     * @brief 走子阶段的排序分
+     */
+    virtual int queenScore(const Position& pos, int from, int to) const = 0;
+
+    /**
+     * @brief 射箭阶段的排序分 (pos 为走子前的局面)
+     */
+    virtual int arrowScore(const Position& pos, int from, int to, int arrow) const = 0;
+};
+
+/**
+ * @brief 默认排序：落点靠近中心，箭落在对方亚马逊周围 (封堵)
+ */
+class DefaultMoveScorer : public MoveScorer {
+public:
+    int queenScore(const Position& pos, int from, int to) const override;
+    int arrowScore(const Position& pos, int from, int to, int arrow) const override;
+
+    static const DefaultMoveScorer& instance();
+};
+
+/**
+ * @brief 分阶段的惰性走法生成器
+ *
+ * 一个完整走法是 走子 × 射箭，一个局面常有上千个。MovePicker 依次给出：
+ * 1. 置换表走法 (校验合法后，不做任何生成)；
+ * 2. 本层的杀手走法 (同样只做合法性校验)；
+ * 3. 全部走子 (至多 4 × 27 个) 一次生成并打分，按分数逐个选出；
+ * 4. 每选出一个走子，才生成并打分它的射箭 (至多 27 个)，同样逐个选出。
+ * 搜索在某个走法处剪枝时，其余走子的射箭既不生成也不打分。
+ * 对象很小 (约 1KB)，放在栈上即可，不做堆分配。
+ */
+class MovePicker {
+public:
+    static constexpr int MAX_QUEEN_MOVES = 4 * 27;
+    static constexpr int MAX_ARROWS = 27;
+    static constexpr int MAX_KILLERS = 2;
+
+    /**
+     * @param killers MAX_KILLERS 个杀手走法 (可为 nullptr)
+     */
+    MovePicker(const Position& pos, const Move& ttMove,
+               const MoveScorer& scorer = DefaultMoveScorer::instance(), const Move* killers = nullptr);
+
+    /**
+     * @brief 下一个走法，全部给出后返回 Move::none()
+     */
+    Move next();
+
+    /**
+     * @brief 至今实际生成 (打分) 过的射箭数，即物化的完整走法数
+     */
+    int generatedMoves() const { return generated; }
+
+private:
+    enum class Stage { TTMove, Killers, GenerateQueens, NextQueen, NextArrow, Done };
+
+    struct Candidate {
+        int8_t from;
+        int8_t to;      // 射箭阶段为箭的格子
+        int score;
+    };
+
+    // 把 [index, count) 中分数最高的换到 index 并返回
+    static const Candidate& pickBest(Candidate* list, int index, int count);
+    void generateQueens();
+    void generateArrows(int from, int to);
+    // 已在前面的阶段给出过
+    bool alreadyTried(const Move& m) const;
+
+    const Position& pos;
+    const MoveScorer& scorer;
+    Move ttMove;
+    Move killers[MAX_KILLERS];
+    int killerIndex = 0;
+    Stage stage;
+    int from = -1;
+    int to = -1;
+    int queenCount = 0;
+    int queenIndex = 0;
+    int arrowCount = 0;
+    int arrowIndex = 0;
+    int generated = 0;
+    Candidate queens[MAX_QUEEN_MOVES];
+    Candidate arrows[MAX_ARROWS];
+};
+
+#endif // MOVEPICKER_H
@@ -0,0 +1,146 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "MappedFile.h"
+#include "Position.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 开局库 (.amzo)：局面哈希 → 带权重的走法
+ *
+ * 文件布局 (小端序)：[Header 32B][positionCount 个 PositionEntry，每个 16 字节，按 key 升序]
+ *                     [moveCount 个 MoveEntry，每个 8 字节]
+ * key 是局面按棋盘对称规范化后的哈希 (Symmetry::canonicalKey)，走法也保存在规范坐标系下，
+ * 因此镜像/旋转后相同的开局只占一项。读取时整体 mmap，查询直接在映射内存上二分查找，
+ * 启动时不做任何解析。由 tools/bookgen 从引擎自对弈生成。
+ */
+namespace OpeningBook {
+
+constexpr char MAGIC[4] = {'A', 'M', 'Z', 'O'};
+constexpr uint16_t VERSION = 1;
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t positionCount;
+    uint32_t moveCount;
+    uint32_t maxPly;            // 收录的最大回合数 (仅供参考)
+    uint8_t reserved[12];
+};
+static_assert(sizeof(Header) == 32, "OpeningBook::Header must stay 32 bytes");
+
+struct PositionEntry {
+    uint64_t key;
+    uint32_t firstMove;         // 在走法段中的下标
+    uint16_t moveCount;
+    uint16_t reserved;
+};
+static_assert(sizeof(PositionEntry) == 16, "OpeningBook::PositionEntry must stay 16 bytes");
+
+struct MoveEntry {
+    uint8_t from;
+    uint8_t to;
+    uint8_t arrow;
+    uint8_t reserved;
+    uint32_t weight;
+};
+static_assert(sizeof(MoveEntry) == 8, "OpeningBook::MoveEntry must stay 8 bytes");
+
+/**
+ * @brief 书中某个局面的一个走法 (已换算回查询局面的坐标系)
+ */
+struct BookMove {
+    Move move;
+    uint32_t weight;
+};
+
+/**
+ * @brief 文件开头是否为开局库的魔数
+ */
+bool isBook(const uint8_t* data, size_t size);
+
+/**
+ * @brief 指向文件映像 (映射内存或 Builder::encode 的结果) 的只读视图
+ */
+class View {
+public:
+    /**
+     * @brief 校验头部与各段大小，以及走法下标不越界
+     */
+    bool open(const uint8_t* data, size_t size);
+
+    bool isOpen() const { return hdr != nullptr; }
+    uint32_t positionCount() const { return hdr ? hdr->positionCount : 0; }
+    uint32_t moveCount() const { return hdr ? hdr->moveCount : 0; }
+
+    /**
+     * @brief pos 在书中的全部走法 (合法性已校验)，写入 out 并返回个数
+     */
+    int moves(const Position& pos, BookMove* out, int maxMoves) const;
+
+    /**
+     * @brief 按权重随机选一个书中走法；不在书中时返回 Move::none()
+     * @param random 调用方提供的 64 位随机数
+     */
+    Move pick(const Position& pos, uint64_t random) const;
+
+    /**
+     * @brief 权重最大的书中走法 (用于预测对手走法)
+     */
+    Move best(const Position& pos) const;
+
+private:
+    const PositionEntry* find(uint64_t key) const;
+
+    const Header* hdr = nullptr;
+    const PositionEntry* positions = nullptr;
+    const MoveEntry* moveTable = nullptr;
+};
+
+/**
+ * @brief 映射到内存的开局库文件
+ */
+class Book {
+public:
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return view.isOpen(); }
+    const View& data() const { return view; }
+
+private:
+    MappedFile file;
+    View view;
+};
+
+/**
+ * @brief 汇总走法统计并编码为开局库
+ *
+ * add 可以来自自对弈、人工分析或已有棋谱；同一局面 (含对称像) 的同一走法权重累加。
+ */
+class Builder {
+public:
+    void add(const Position& pos, const Move& move, uint32_t weight = 1);
+
+    /**
+     * @brief 编码为完整的文件映像
+     * @param minWeight 权重低于此值的走法不收录 (过滤偶然出现的走法)
+     */
+    std::vector<uint8_t> encode(uint32_t minWeight = 1, uint32_t maxPly = 0) const;
+    bool write(const std::string& path, uint32_t minWeight = 1, uint32_t maxPly = 0) const;
+
+    size_t positionCount() const { return table.size(); }
+
+private:
+    // 规范坐标系下的走法，按 from/to/arrow 打包为 18 位
+    std::map<uint64_t, std::map<uint32_t, uint64_t>> table;
+};
+
+} // namespace OpeningBook
+
+#endif // OPENINGBOOK_H
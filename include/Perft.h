@@ -0,0 +1,45 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Position.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// --- perft：走法生成的正确性与吞吐量基准 ---
+//
+// 统计从某局面出发恰好走 depth 个完整回合 (走子 + 射箭) 的走法序列数。中途无子可动的
+// 分支不计数。最后一层不逐个执行走法，直接按射箭目标的位数累加 (bulk counting)。
+
+namespace Perft {
+
+struct Options {
+    int threads = 1;            // 根节点的走法分给多个线程 (depth >= 2 时生效)
+    size_t hashMB = 0;          // > 0 时用共享的置换表缓存 (局面, 剩余深度) 的计数
+};
+
+struct Result {
+    uint64_t nodes = 0;         // 叶子数 (即 perft 值)
+    int elapsedMs = 0;
+
+    double nodesPerSecond() const { return elapsedMs > 0 ? nodes * 1000.0 / elapsedMs : 0.0; }
+};
+
+/**
+ * @brief 单线程、不带缓存的 perft
+ */
+uint64_t count(const Position& pos, int depth);
+
+/**
+ * @brief 按 options 运行 perft 并计时
+ */
+Result run(const Position& pos, int depth, const Options& options = Options());
+
+/**
+ * @brief 根节点每个走法各自的 perft 值 (depth - 1)，用于与其它实现逐项对比
+ */
+std::vector<std::pair<Move, uint64_t>> divide(const Position& pos, int depth);
+
+} // namespace Perft
+
+#endif // PERFT_H
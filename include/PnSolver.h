@@ -0,0 +1,136 @@
+#ifndef PNSOLVER_H
+#define PNSOLVER_H
+
+#include "Position.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Tablebase { class View; }
+
+/**
+ * @brief 证明数搜索的结论 (以根节点行棋方的视角)
+ */
+enum class SolveStatus : int8_t {
+    Loss = -1,      // 已证明必败：无论怎么走对方都有必胜应对
+    Unknown = 0,    // 预算耗尽或被中止
+    Win = 1         // 已证明必胜
+};
+
+/**
+ * @brief 一次求解的结果与统计
+ */
+struct SolveResult {
+    SolveStatus status = SolveStatus::Unknown;
+    Move best = Move::none();   // 必胜时为取胜走法 (根节点本身已由 Regions::decide 判定时为空)
+    uint64_t nodes = 0;         // 展开的节点数
+    int elapsedMs = 0;
+};
+
+/**
+ * @brief 深度优先证明数搜索 (df-pn) 求解器
+ *
+ * 用于残局：只看 "谁赢"，不看分数。每个节点保存以行棋方视角的证明数 phi (证明行棋方
+ * 必胜至少还要展开的叶子数) 与否证数 delta；phi(n) = min delta(子)，delta(n) = Σ phi(子)。
+ * 搜索沿决定 phi 的子节点 (delta 最小者) 下行，用阈值控制何时回溯，节点的数值保存在自带的定长置换表中
+ * (与 Alpha-Beta 的置换表相互独立)，因此内存有界，且求解结果跨回合保留：证明了必胜之后，
+ * 沿证明树往下的局面再次求解时直接命中。子节点阈值采用 1+ε 技巧，减少在两个相近子树之间
+ * 反复切换。
+ *
+ * 亚马逊每回合恰好占用一个空格，局面之间没有循环，不存在 GHI 问题；无子可动者负，
+ * 双方分隔且 Regions::decide 已定胜负的局面直接作为叶子。
+ * 只在双方还能到达的空格不超过 MAX_SQUARES 个时使用，此时完整证明通常可在秒级完成。
+ */
+class PnSolver {
+public:
+    explicit PnSolver(size_t megabytes = DEFAULT_SIZE_MB);
+
+    static const size_t DEFAULT_SIZE_MB = 16;
+    // 适用范围：双方亚马逊可到达的空格总数上限
+    static constexpr int MAX_SQUARES = 25;
+    // 每回合占用一个空格，求解深度不会超过可到达的空格数
+    static constexpr int MAX_PLY = MAX_SQUARES + 2;
+
+    /**
+     * @brief 局面是否在求解器的适用范围内 (可到达的空格不超过 MAX_SQUARES)
+     */
+    static bool applicable(const Position& pos);
+
+    /**
+     * @brief 求解 pos (行棋方为 pos.sideToMove)
+     * @param stop 中止标志 (可选)，置位后尽快返回 Unknown
+     * @param maxNodes 展开节点数上限 (0 表示不限)
+     * @param tablebase 孤立区域残局库 (可选)，用于判定已分隔的局面
+     */
+    SolveResult solve(const Position& pos, const std::atomic<bool>* stop = nullptr, uint64_t maxNodes = 0,
+                      const Tablebase::View* tablebase = nullptr);
+
+    /**
+     * @brief 只查表：之前的求解已证明的结论 (不展开任何节点)
+     */
+    SolveResult lookup(const Position& pos) const;
+
+    /**
+     * @brief 从置换表中取出证明树的主线 (必胜方的取胜走法与对方的应对)
+     * @return 写入 out 的走法数
+     */
+    int provenLine(const Position& pos, Move* out, int maxMoves) const;
+
+    /**
+     * @brief 重新分配置换表 (会清空已有结论)
+     */
+    void resize(size_t megabytes);
+    void clear();
+
+private:
+    static constexpr uint32_t INF = 1u << 30;
+
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t phi = 0;
+        uint32_t delta = 0;
+        uint32_t work = 0;          // 求解该节点花费的节点数 (饱和)，替换时保留代价大的
+        Move best = Move::none();
+        uint8_t generation = 0;
+    };
+    static const int BUCKET_SIZE = 4;
+    struct Bucket {
+        Entry entries[BUCKET_SIZE];
+    };
+
+    // 节点 (或子节点) 的证明数、否证数与最佳走法
+    struct Numbers {
+        uint32_t phi;
+        uint32_t delta;
+        Move best;
+    };
+
+    struct Child {
+        Move move;
+        uint32_t phi;
+        uint32_t delta;
+    };
+
+    const Entry* find(uint64_t key) const;
+    void store(uint64_t key, const Numbers& n, uint64_t work);
+    Numbers evaluate(const Position& pos) const;
+    Numbers mid(Position& pos, uint32_t thPhi, uint32_t thDelta, int ply);
+    bool shouldStop();
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint64_t bucketMask = 0;
+    uint8_t generation = 0;
+
+    // 每层的子节点数组，构造时一次性分配，求解过程中不做堆分配
+    std::unique_ptr<Child[]> childStack;
+
+    const std::atomic<bool>* stopFlag = nullptr;
+    const Tablebase::View* tablebase = nullptr;
+    uint64_t nodes = 0;
+    uint64_t nodeLimit = 0;
+    bool aborted = false;
+};
+
+#endif // PNSOLVER_H
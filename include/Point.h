@@ -0,0 +1,16 @@
+#ifndef POINT_H
+#define POINT_H
+
+/**
+ * @brief 坐标结构 (界面、存档与规则接口共用，不依赖 Qt)
+ */
+struct Point {
+    int col;
+    int row;
+
+    bool operator==(const Point& other) const {
+        return col == other.col && row == other.row;
+    }
+};
+
+#endif // POINT_H
@@ -0,0 +1,134 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "Bitboard.h"
+#include "Zobrist.h"
+#include <string>
+
+/**
+ * @brief 完整一步 (走子 + 射箭)，以格子索引表示
+ */
+struct Move {
+    int8_t from;
+    int8_t to;
+    int8_t arrow;
+
+    bool operator==(const Move& other) const {
+        return from == other.from && to == other.to && arrow == other.arrow;
+    }
+    bool isNull() const { return from < 0; }
+    static Move none() { return {-1, -1, -1}; }
+};
+
+/**
+ * @brief 位棋盘局面：红蓝双方亚马逊各一个 64 位字，障碍(箭)一个 64 位字
+ *
+ * 这是规则判定与 AI 搜索使用的唯一盘面表示；AmazonBoard 只在 UI 与存档
+ * 时与之互相转换。
+ */
+struct Position {
+    Bitboard amazons[2] = {0, 0}; // 按 user 索引: [0] 蓝方, [1] 红方
+    Bitboard arrows = 0;
+    int sideToMove = 1;           // 1: 红方, 0: 蓝方
+    uint64_t hash = 0;            // Zobrist 哈希，随走子/射箭增量更新
+
+    /**
+     * @brief 标准 8x8 开局 (红方先手)
+     */
+    static Position startPosition();
+
+    /**
+     * @brief 文本表示 (命令行工具与测试局面使用)
+     *
+     * 从第 7 行到第 0 行，每行自第 0 列起：'R' 红方亚马逊、'B' 蓝方亚马逊、'x' 箭，
+     * 数字 1-8 为连续空格数，行间用 '/' 分隔；之后空一格，'r' 或 'b' 表示行棋方。
+     * 标准开局为 "2B2B2/8/B6B/8/8/R6R/8/2R2R2 r"。
+     */
+    std::string toString() const;
+
+    /**
+     * @brief 解析 toString 的格式，格式错误返回 false (out 不变)
+     */
+    static bool fromString(const std::string& text, Position& out);
+
+    /**
+     * @brief 从头计算 Zobrist 哈希 (仅在直接修改位棋盘字段后需要调用)
+     */
+    uint64_t computeHash() const;
+    void refreshHash() { hash = computeHash(); }
+
+    void setSideToMove(int side) {
+        if (side != sideToMove) hash ^= Zobrist::side();
+        sideToMove = side;
+    }
+
+    Bitboard occupied() const { return amazons[0] | amazons[1] | arrows; }
+    Bitboard empty() const { return ~occupied(); }
+
+    /**
+     * @brief 获取指定格子的棋子
+     * @return 如果有棋子返回用户ID(0或1)，否则返回 -1
+     */
+    int pieceAt(int sq) const {
+        Bitboard b = Bitboards::squareBB(sq);
+        if (amazons[1] & b) return 1;
+        if (amazons[0] & b) return 0;
+        return -1;
+    }
+
+    bool hasArrowAt(int sq) const { return (arrows >> sq) & 1; }
+    bool isOccupied(int sq) const { return (occupied() >> sq) & 1; }
+
+    /**
+     * @brief 某格子上的亚马逊可到达的格子 (也即从该格子射箭可命中的格子)
+     */
+    Bitboard reachable(int sq) const { return Bitboards::queenAttacks(sq, occupied()); }
+
+    /**
+     * @brief 某方是否至少有一步可走 (任一亚马逊周围存在空格即可)
+     */
+    bool canMove(int player) const {
+        return (Bitboards::kingSpread(amazons[player]) & empty()) != 0;
+    }
+
+    /**
+     * @brief 校验行棋方的一个完整走法是否合法 (用于校验来自置换表/外部的走法)
+     */
+    bool isLegal(const Move& m) const;
+
+    // --- 底层修改 (不做合法性校验) ---
+    void moveAmazon(int player, int from, int to) {
+        amazons[player] ^= Bitboards::squareBB(from) | Bitboards::squareBB(to);
+        hash ^= Zobrist::amazon(player, from) ^ Zobrist::amazon(player, to);
+    }
+    void placeArrow(int sq) {
+        arrows |= Bitboards::squareBB(sq);
+        hash ^= Zobrist::arrow(sq);
+    }
+    void removeArrow(int sq) {
+        arrows &= ~Bitboards::squareBB(sq);
+        hash ^= Zobrist::arrow(sq);
+    }
+
+    /**
+     * @brief 执行一个完整回合 (走子、射箭、换手)
+     */
+    void makeMove(const Move& m) {
+        moveAmazon(sideToMove, m.from, m.to);
+        placeArrow(m.arrow);
+        sideToMove ^= 1;
+        hash ^= Zobrist::side();
+    }
+
+    /**
+     * @brief 撤销 makeMove
+     */
+    void unmakeMove(const Move& m) {
+        sideToMove ^= 1;
+        hash ^= Zobrist::side();
+        removeArrow(m.arrow);
+        moveAmazon(sideToMove, m.to, m.from);
+    }
+};
+
+#endif // POSITION_H
@@ -0,0 +1,111 @@
+#ifndef REGIONS_H
+#define REGIONS_H
+
+#include "Position.h"
+#include "Tablebase.h"
+
+// --- 空格连通区域：划分、归属与提前判定胜负 ---
+//
+// 亚马逊的每一步 (以及射箭) 都只经过空格，且皇后走法经过的格子两两王步相邻，
+// 因此以王步相邻划分空格得到的连通区域就是双方实际能争夺的范围。
+// 一个区域只与一方的亚马逊相邻时归该方所有，两方都相邻为争夺中，都不相邻为死区。
+// 所有区域都不再争夺时对局变成双方各自填空：谁能走的步数多谁赢。
+
+namespace Regions {
+
+enum class Kind : uint8_t {
+    Dead,       // 没有亚马逊相邻，任何一方都用不到
+    Owned,      // 只与一方的亚马逊相邻
+    Contested   // 与双方的亚马逊都相邻
+};
+
+struct Region {
+    Bitboard squares = 0;
+    Kind kind = Kind::Dead;
+    int8_t owner = -1;      // Owned 时的所属方
+
+    int area() const { return Bitboards::popCount(squares); }
+};
+
+// 王步连通的空格区域至多 16 个 (8x8 王步图的最大独立集)
+constexpr int MAX_REGIONS = 16;
+
+/**
+ * @brief 从 seeds 出发、只经过 within 中格子的王步泛洪 (结果含 seeds ∩ within)
+ */
+Bitboard flood(Bitboard seeds, Bitboard within);
+
+/**
+ * @brief 双方是否已完全分隔 (没有任何争夺中的区域)，只需一次泛洪
+ */
+bool separated(const Position& pos);
+
+/**
+ * @brief 分隔后的胜负判定
+ *
+ * 步数上界是己方区域的空格数 (每回合恰好占用一个空格)；下界是各亚马逊沿互不相交的
+ * 王步路径逐格前进、每步把箭射回刚离开的格子所能走的步数 (贪心选路)。
+ * 行棋方先走，步数多于对方才能获胜，因此下界 > 对方上界即必胜，上界 <= 对方下界即必败。
+ * 给出残局库且一方每个亚马逊的区域互不相交、都已收录时，该方的步数是精确值 (上下界相等)。
+ */
+struct Outcome {
+    bool decided = false;
+    int winner = -1;
+    int margin = 0;         // 胜方下界减去负方上界 (>= 0)，越大胜得越稳
+};
+
+/**
+ * @brief 已分隔且胜负已定时给出结果，否则 decided 为 false (未分隔时代价只有一次泛洪)
+ * @param tablebase 孤立区域残局库 (可为 nullptr)
+ */
+Outcome decide(const Position& pos, const Tablebase::View* tablebase = nullptr);
+
+/**
+ * @brief 分隔后 player 至少能走的步数 (见 Outcome)
+ */
+int moveLowerBound(const Position& pos, int player);
+
+} // namespace Regions
+
+/**
+ * @brief 增量维护的区域划分 (对局引擎使用)
+ *
+ * 格子被占用或空出时，只有包含这些格子或与之相邻的区域需要重新泛洪，其余区域保持不变。
+ */
+class RegionMap {
+public:
+    RegionMap() = default;
+    explicit RegionMap(const Position& pos) { reset(pos); }
+
+    /**
+     * @brief 从头划分
+     */
+    void reset(const Position& pos);
+
+    /**
+     * @brief 局面中 changed 里的格子改变了占用状态 (走子起点/落点、箭) 后调用
+     */
+    void update(const Position& pos, Bitboard changed);
+
+    int count() const { return regionCount; }
+    const Regions::Region& operator[](int i) const { return regions[i]; }
+
+    /**
+     * @brief 没有争夺中的区域
+     */
+    bool separated() const;
+
+    /**
+     * @brief player 独占区域的空格总数
+     */
+    int ownedArea(int player) const;
+
+private:
+    void classify(Regions::Region& r, const Position& pos) const;
+    void floodRemaining(Bitboard squares, const Position& pos);
+
+    Regions::Region regions[Regions::MAX_REGIONS];
+    int regionCount = 0;
+};
+
+#endif // REGIONS_H
@@ -0,0 +1,95 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "Position.h"
+
+// --- 棋盘对称 (二面体群 D4) 与局面规范化 ---
+//
+// 8x8 棋盘在 4 种旋转、4 种翻转下不变，皇后走法与王步相邻也随之不变；规则对双方对称，
+// 交换颜色并交换行棋方后局面的胜负也不变。因此一个局面与它的 8 个对称像 (以及交换颜色
+// 后的像) 可以共用置换表条目、开局库条目与残局库条目。
+//
+// 变换编号 t 的三个位依次表示：1 左右翻转 (列)，2 上下翻转 (行)，4 沿 a1-h8 对角线转置，
+// 按这个顺序作用。全部由整字位运算完成，不逐格重排。
+
+namespace Symmetry {
+
+constexpr int COUNT = 8;
+
+inline Bitboard flipCols(Bitboard b) {
+    const Bitboard k1 = 0x5555555555555555ULL, k2 = 0x3333333333333333ULL, k4 = 0x0F0F0F0F0F0F0F0FULL;
+    b = ((b >> 1) & k1) | ((b & k1) << 1);
+    b = ((b >> 2) & k2) | ((b & k2) << 2);
+    b = ((b >> 4) & k4) | ((b & k4) << 4);
+    return b;
+}
+
+inline Bitboard flipRows(Bitboard b) { return __builtin_bswap64(b); }
+
+// 行列互换 (沿 a1-h8 对角线翻转)
+inline Bitboard transpose(Bitboard b) {
+    const Bitboard k1 = 0x5500550055005500ULL, k2 = 0x3333000033330000ULL, k4 = 0x0F0F0F0F00000000ULL;
+    Bitboard t = k4 & (b ^ (b << 28));
+    b ^= t ^ (t >> 28);
+    t = k2 & (b ^ (b << 14));
+    b ^= t ^ (t >> 14);
+    t = k1 & (b ^ (b << 7));
+    b ^= t ^ (t >> 7);
+    return b;
+}
+
+inline Bitboard apply(Bitboard b, int t) {
+    if (t & 1) b = flipCols(b);
+    if (t & 2) b = flipRows(b);
+    if (t & 4) b = transpose(b);
+    return b;
+}
+
+/**
+ * @brief 逆变换：不含转置时翻转自逆；含转置时先转置再翻转，等价于交换两种翻转后再转置
+ */
+constexpr int inverse(int t) {
+    return (t & 4) ? 4 | ((t & 1) << 1) | ((t >> 1) & 1) : t;
+}
+
+constexpr int applySquare(int sq, int t) {
+    int col = (t & 1) ? 7 - Bitboards::colOf(sq) : Bitboards::colOf(sq);
+    int row = (t & 2) ? 7 - Bitboards::rowOf(sq) : Bitboards::rowOf(sq);
+    return (t & 4) ? Bitboards::squareOf(row, col) : Bitboards::squareOf(col, row);
+}
+
+inline Move apply(const Move& m, int t) {
+    if (m.isNull()) return m;
+    return {int8_t(applySquare(m.from, t)), int8_t(applySquare(m.to, t)), int8_t(applySquare(m.arrow, t))};
+}
+
+/**
+ * @brief 局面的规范键
+ *
+ * 规范代表元：先交换颜色使行棋方为红方 (1)，再在 8 个对称像中取 (箭, 行棋方, 对方)
+ * 三个位棋盘字典序最小者。hash 是代表元的 Zobrist 哈希；走法在规范坐标系与原局面之间
+ * 用 transform 换算 (交换颜色不影响格子)。
+ */
+struct Key {
+    uint64_t hash = 0;
+    int transform = 0;
+
+    Move toCanonical(const Move& m) const { return apply(m, transform); }
+    Move fromCanonical(const Move& m) const { return apply(m, inverse(transform)); }
+};
+
+/**
+ * @brief 规范代表元本身 (行棋方为红方)
+ */
+Position canonicalize(const Position& pos, int* transform = nullptr);
+
+Key canonicalKey(const Position& pos);
+
+/**
+ * @brief 局面在某个对称变换下的像 (不交换颜色，哈希重新计算)
+ */
+Position apply(const Position& pos, int t);
+
+} // namespace Symmetry
+
+#endif // SYMMETRY_H
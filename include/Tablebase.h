@@ -0,0 +1,117 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "Bitboard.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 孤立区域残局库 (.amzt)
+ *
+ * 双方分隔之后，一个亚马逊独占的空格区域里最多能走几步只取决于区域形状与亚马逊的位置。
+ * 残局库按 "区域空格 + 亚马逊所在格" 保存这个步数，区域经平移到左下角并在 8 种对称
+ * 变换 (Symmetry.h) 中取最小者规范化，因此同一形状的所有摆法共用一项。由 tools/tbgen 离线生成。
+ *
+ * 文件布局 (小端序)：[Header 32B][slotCount 个 Entry，每个 16 字节]
+ * 条目是一张开放寻址 (线性探测) 哈希表，cells 为 0 的槽位为空。读取时整体 mmap，
+ * 查询直接在映射内存上进行，不做任何解析。
+ */
+namespace Tablebase {
+
+constexpr char MAGIC[4] = {'A', 'M', 'Z', 'T'};
+constexpr uint16_t VERSION = 1;
+// 生成器支持的最大区域 (空格数)；再大条目数会超过数千万
+constexpr int MAX_SQUARES = 10;
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint8_t maxSquares;         // 收录的最大区域空格数
+    uint8_t reserved[7];
+    uint64_t slotCount;         // 哈希表槽位数 (2 的幂)
+    uint64_t entryCount;
+};
+static_assert(sizeof(Header) == 32, "Tablebase::Header must stay 32 bytes");
+
+/**
+ * @brief 规范化后的查询键：区域空格加上亚马逊所在格
+ */
+struct Key {
+    uint64_t cells;             // 空格 ∪ 亚马逊所在格，已平移到左下角
+    uint8_t amazon;
+
+    bool operator==(const Key& o) const { return cells == o.cells && amazon == o.amazon; }
+    bool operator<(const Key& o) const { return cells != o.cells ? cells < o.cells : amazon < o.amazon; }
+};
+
+struct Entry {
+    uint64_t cells;
+    uint8_t amazon;
+    uint8_t moves;              // 该亚马逊在区域内最多能走的步数
+    uint8_t reserved[6];
+};
+static_assert(sizeof(Entry) == 16, "Tablebase::Entry must stay 16 bytes");
+
+/**
+ * @brief 规范化：area 为亚马逊可到达的空格区域 (与 amazon 王步连通)
+ */
+Key canonicalKey(Bitboard area, int amazon);
+
+/**
+ * @brief 把条目编码为完整的文件映像 (哈希表装载率不超过 1/2)
+ */
+std::vector<uint8_t> encode(int maxSquares, const std::vector<Entry>& entries);
+
+/**
+ * @brief 文件开头是否为残局库的魔数
+ */
+bool isTablebase(const uint8_t* data, size_t size);
+
+/**
+ * @brief 指向文件映像 (映射内存或 encode 的结果) 的只读视图
+ */
+class View {
+public:
+    /**
+     * @brief 校验头部与表的大小
+     */
+    bool open(const uint8_t* data, size_t size);
+
+    bool isOpen() const { return hdr != nullptr; }
+    int maxSquares() const { return hdr ? hdr->maxSquares : 0; }
+    uint64_t entryCount() const { return hdr ? hdr->entryCount : 0; }
+
+    /**
+     * @brief amazon 独占 area 时最多能走的步数；area 为空返回 0，未收录返回 -1
+     */
+    int probe(Bitboard area, int amazon) const;
+    int probe(const Key& key) const;
+
+private:
+    const Header* hdr = nullptr;
+    const Entry* slots = nullptr;
+};
+
+/**
+ * @brief 映射到内存的残局库文件
+ */
+class Table {
+public:
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return view.isOpen(); }
+    const View& data() const { return view; }
+
+private:
+    MappedFile file;
+    View view;
+};
+
+} // namespace Tablebase
+
+#endif // TABLEBASE_H
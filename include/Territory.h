@@ -0,0 +1,86 @@
+#ifndef TERRITORY_H
+#define TERRITORY_H
+
+#include "Position.h"
+
+// --- 领地评估：皇后步/王步距离 (Lieberum 特征) ---
+
+namespace Territory {
+
+// 距离层数上限 (王步距离最坏情况下可接近空格数)
+constexpr int MAX_LAYERS = 64;
+
+/**
+ * @brief 双方到每个空格的皇后步 / 王步距离，按层保存
+ *
+ * queen[c][k] 是 c 方恰好需要 k 次皇后走法才能到达的空格 (k >= 1)，king 同理；
+ * 不在任何一层中的空格表示该方无法到达 (距离为无穷)。
+ */
+struct DistanceMaps {
+    Bitboard queen[2][MAX_LAYERS];
+    Bitboard king[2][MAX_LAYERS];
+    int queenLayers[2];     // 最大的有效 k
+    int kingLayers[2];
+    Bitboard queenReached[2];
+    Bitboard kingReached[2];
+
+    /**
+     * @brief 格子 sq 的皇后步距离，无法到达返回 -1 (调试/显示用)
+     */
+    int queenDistance(int player, int sq) const;
+    int kingDistance(int player, int sq) const;
+};
+
+/**
+ * @brief 从 player 视角的领地与位置特征
+ *
+ * t1/t2: 皇后步/王步距离下更近的空格数之差，距离相等的格子按行棋方记 ±1/5；
+ * c1 = 2 * Σ(2^-D1 - 2^-D1'), c2 = Σ clamp((D2' - D2) / 6, -1, 1)；
+ * w = Σ 2^-|D1 - D1'| (双方都能到达的格子)，接近 0 时双方已基本隔离。
+ */
+struct Features {
+    double t1 = 0;
+    double t2 = 0;
+    double c1 = 0;
+    double c2 = 0;
+    double w = 0;
+};
+
+/**
+ * @brief 泛洪填充使用的指令集
+ */
+enum class SimdLevel {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+/**
+ * @brief 当前使用的指令集 (首次调用时按 CPU 检测，选择最快的可用实现)
+ */
+SimdLevel simdLevel();
+
+/**
+ * @brief 强制使用某个实现 (用于对比测试)，CPU 不支持时退回可用的最高级别
+ * @return 实际生效的级别
+ */
+SimdLevel setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief 以按位并行的 Kogge-Stone 泛洪计算双方的距离层
+ */
+void computeDistances(const Position& pos, DistanceMaps& maps);
+
+Features features(const Position& pos, int player);
+Features features(const DistanceMaps& maps, int player, int sideToMove);
+
+/**
+ * @brief 按对局阶段 (w) 混合各项特征，单位与 Evaluation 相同 (1 步灵活性 = 2 分)
+ */
+int evaluate(const Position& pos, int player);
+
+} // namespace Territory
+
+#endif // TERRITORY_H
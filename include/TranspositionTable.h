@@ -0,0 +1,119 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "Position.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief 置换表条目中分数的类型
+ */
+enum class TTBound : uint8_t {
+    None = 0,
+    Upper = 1,  // 失败低：真实分数 <= score
+    Lower = 2,  // 失败高：真实分数 >= score
+    Exact = 3
+};
+
+/**
+ * @brief 置换表探测结果 (已解包)
+ */
+struct TTEntry {
+    Move move = Move::none();
+    int score = 0;
+    int depth = 0;
+    TTBound bound = TTBound::None;
+};
+
+/**
+ * @brief 统计信息快照
+ */
+struct TTStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+
+    double hitRate() const { return probes ? double(hits) / double(probes) : 0.0; }
+};
+
+/**
+ * @brief 固定大小、分桶、按深度替换的置换表
+ *
+ * 每个桶 4 个条目，正好占一条 64 字节缓存行。条目由两个 64 位原子字组成：
+ * data 与 (key ^ data)。读写都不加锁，读取时重新异或校验，撕裂的写入会被当作
+ * 未命中丢弃，因此多个搜索线程可以并发访问而无需全局互斥锁。
+ */
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB);
+
+    static const size_t DEFAULT_SIZE_MB = 16;
+
+    /**
+     * @brief 重新分配表 (会清空内容)，不可与搜索并发调用
+     */
+    void resize(size_t megabytes);
+    void clear();
+    size_t sizeMB() const { return bucketCount * sizeof(Bucket) / (1024 * 1024); }
+
+    /**
+     * @brief 每次新的搜索开始前调用，旧代条目会被优先替换
+     */
+    void newSearch() { generation = (generation + 1) & GENERATION_MASK; }
+
+    bool probe(uint64_t key, TTEntry& out) const;
+    void store(uint64_t key, const Move& move, int score, int depth, TTBound bound);
+
+    /**
+     * @brief 预取桶所在的缓存行
+     */
+    void prefetch(uint64_t key) const { __builtin_prefetch(&buckets[key & bucketMask]); }
+
+    TTStats stats() const;
+    void resetStats();
+
+    /**
+     * @brief 采样前 1000 个桶估算填充率 (千分比)
+     */
+    int hashfull() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;
+    };
+    static const int BUCKET_SIZE = 4;
+    struct alignas(64) Bucket {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    // 按线程分片的计数器，避免所有线程在同一条缓存行上争用
+    static const int COUNTER_SHARDS = 16;
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> probes{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> stores{0};
+    };
+    Counter& counter() const;
+
+    static const uint8_t GENERATION_MASK = 0x3F;
+
+    // data 的位布局
+    // [0..17]  走法 (from/to/arrow 各 6 位)   [18] 是否有走法
+    // [19..20] 界类型                         [21..27] 深度
+    // [28..33] 代                             [34..63] 分数 (有符号 30 位)
+    static uint64_t pack(const Move& move, int score, int depth, TTBound bound, uint8_t gen);
+    static TTEntry unpack(uint64_t data);
+    static int depthOf(uint64_t data) { return int((data >> 21) & 0x7F); }
+    static uint8_t generationOf(uint64_t data) { return uint8_t((data >> 28) & GENERATION_MASK); }
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint64_t bucketMask = 0;
+    uint8_t generation = 0;
+    mutable Counter counters[COUNTER_SHARDS];
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,113 @@
+#ifndef UNDOLOG_H
+#define UNDOLOG_H
+
+#include "Position.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 悔棋日志中一个回合的增量记录 (4 字节)
+ *
+ * 只记录走子、射箭以及走子前的对局状态，撤销/重做时在当前盘面上反向/正向应用。
+ */
+struct PlyRecord {
+    int8_t from;
+    int8_t to;
+    int8_t arrow;       // -1 表示本回合尚未射箭
+    uint8_t prior;      // 走子前的状态：bit0 是否已结束，bit1-2 胜者 + 1 (0 表示无)
+
+    static PlyRecord make(int from, int to, bool priorFinished, int priorWinner) {
+        uint8_t prior = uint8_t((priorFinished ? 1 : 0) | ((priorWinner + 1) & 0x3) << 1);
+        return {int8_t(from), int8_t(to), int8_t(-1), prior};
+    }
+
+    bool complete() const { return arrow >= 0; }
+    bool priorFinished() const { return prior & 1; }
+    int priorWinner() const { return int((prior >> 1) & 0x3) - 1; }
+    Move move() const { return {from, to, arrow}; }
+};
+
+/**
+ * @brief 基于增量记录的悔棋/重做日志
+ *
+ * 撤销与重做都是 O(1)：只移动游标并返回需要应用的记录。每 CHECKPOINT_INTERVAL
+ * 个完整回合保存一个局面检查点，跳转到任意回合时从最近的检查点重放不超过
+ * CHECKPOINT_INTERVAL 个记录。平均每回合占用约 4 + sizeof(Position) / 32 字节。
+ */
+class UndoLog {
+public:
+    static constexpr int CHECKPOINT_INTERVAL = 32;
+
+    UndoLog() { reset(Position()); }
+
+    /**
+     * @brief 清空日志，以 start 作为第 0 回合的局面
+     */
+    void reset(const Position& start);
+
+    /**
+     * @brief 载入存档后调用：由当前局面与已有记录反推起始局面并重建检查点
+     * @param current 游标 (ply()) 处的局面
+     * @return 记录与局面一致时返回 true；否则清空日志并返回 false
+     */
+    bool rebuild(const Position& current);
+
+    /**
+     * @brief 记录一次走子 (尚未射箭)，会丢弃游标之后可重做的记录
+     */
+    void push(const PlyRecord& rec);
+
+    /**
+     * @brief 为最后一条记录补上箭的位置
+     * @param after 射箭之后的局面 (用于在整数倍处保存检查点)
+     */
+    void complete(int arrow, const Position& after);
+
+    /**
+     * @brief 撤销游标前的一条记录
+     *
+     * 尚未射箭的记录会被直接丢弃 (不可重做)。
+     */
+    bool undo(PlyRecord& out);
+
+    /**
+     * @brief 重做游标后的一条完整记录
+     */
+    bool redo(PlyRecord& out);
+
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor < int(records.size()); }
+
+    /**
+     * @brief 第 n 个完整回合之后的局面 (0 <= n <= completedPlies())
+     */
+    Position positionAt(int n) const;
+
+    /**
+     * @brief 移动游标到第 n 个完整回合，调用方负责同步盘面
+     */
+    bool seek(int n);
+
+    int ply() const { return cursor; }
+    int length() const { return int(records.size()); }
+    int completedPlies() const;
+    const PlyRecord& at(int i) const { return records[i]; }
+    const std::vector<PlyRecord>& entries() const { return records; }
+
+    /**
+     * @brief 从存档恢复记录与游标，随后需要调用 rebuild()
+     */
+    void assign(const std::vector<PlyRecord>& recs, int plyCursor);
+
+    size_t memoryBytes() const {
+        return records.capacity() * sizeof(PlyRecord) + checkpoints.capacity() * sizeof(Position);
+    }
+
+private:
+    std::vector<PlyRecord> records;
+    std::vector<Position> checkpoints; // checkpoints[k]: 第 k * CHECKPOINT_INTERVAL 回合之后的局面
+    int cursor = 0;                    // 已应用的记录数
+};
+
+#endif // UNDOLOG_H
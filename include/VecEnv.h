@@ -0,0 +1,129 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+#include "Position.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// --- 批量对局环境 (训练与数据生成用) ---
+//
+// N 局同时推进：每个字段是一个长度为 N 的连续数组 (SoA)，step 一次接收 N 个走法，
+// 奖励、结束标志与观测也按局连续输出，可以直接交给张量库。不维护 Zobrist 哈希、
+// 悔棋记录或任何字符串状态，每步只做几次位棋盘查表。
+
+struct VecEnvOptions {
+    int threads = 1;                // step/reset/采样的线程数 (常驻线程池)
+    int randomOpeningPlies = 0;     // 每局开始前随机走的回合数 (分散开局)
+    bool adjudicate = false;        // 区域已分隔且胜负已定时提前结束 (Regions::decide)
+    uint64_t seed = 1;              // 各局随机数的种子 (开局与 sampleActions)
+};
+
+/**
+ * @brief N 局亚马逊棋的批量环境
+ *
+ * 动作是打包的完整走法：from | to << 6 | arrow << 12 (packAction)。奖励从刚走棋一方的视角：
+ * 走完后对方无子可动 (或开启 adjudicate 时胜负已定) 为 +1；走法不合法判负，为 -1；
+ * 其余为 0。对局结束时 dones 置 1，winners/episodeLengths 记录这局的结果，环境随即
+ * 自动重置，之后读到的观测已经是新一局的开局。
+ */
+class VecEnv {
+public:
+    static constexpr int PLANES = 3;                // 行棋方亚马逊、对方亚马逊、箭
+    static constexpr int MOVE_MASK_SIZE = 64 * 64;  // from * 64 + to
+
+    explicit VecEnv(int count, const VecEnvOptions& options = VecEnvOptions());
+    ~VecEnv();
+
+    VecEnv(const VecEnv&) = delete;
+    VecEnv& operator=(const VecEnv&) = delete;
+
+    int size() const { return count; }
+
+    static uint32_t packAction(const Move& m) {
+        return uint32_t(m.from) | (uint32_t(m.to) << 6) | (uint32_t(m.arrow) << 12);
+    }
+    static Move unpackAction(uint32_t a) {
+        return {int8_t(a & 0x3F), int8_t((a >> 6) & 0x3F), int8_t((a >> 12) & 0x3F)};
+    }
+
+    /**
+     * @brief 重置全部对局 (清除 dones)
+     */
+    void reset();
+
+    /**
+     * @brief 每局执行 actions[i]，结束的对局自动重置
+     */
+    void step(const uint32_t* actions);
+
+    /**
+     * @brief 为每局均匀随机选一个合法走法 (先选可动的亚马逊，再选落点与箭)
+     */
+    void sampleActions(uint32_t* out);
+
+    // --- 最近一次 step 的结果，各 N 项 ---
+    const float* rewards() const { return rewardBuf.data(); }
+    const uint8_t* dones() const { return doneBuf.data(); }
+    const int8_t* winners() const { return winnerBuf.data(); }              // dones 为 1 时有效：1 红方，0 蓝方
+    const uint16_t* episodeLengths() const { return lengthBuf.data(); }     // dones 为 1 时有效
+
+    // --- 当前局面 (位棋盘)，各 N 项 ---
+    const Bitboard* amazons(int player) const { return amazonBuf[player].data(); }
+    const Bitboard* arrows() const { return arrowBuf.data(); }
+    const uint8_t* sideToMove() const { return sideBuf.data(); }
+
+    /**
+     * @brief 以行棋方视角输出棋盘平面：out 为 [N][PLANES][64] 的 0/1
+     */
+    void writePlanes(float* out) const;
+
+    /**
+     * @brief 走子部分的合法性掩码：out 为 [N][MOVE_MASK_SIZE]，from * 64 + to 可走时为 1
+     */
+    void writeMoveMasks(uint8_t* out) const;
+
+    /**
+     * @brief 第 i 局中 from 的亚马逊走到 to 之后可以射箭的格子 (from 须为行棋方的亚马逊)
+     */
+    Bitboard arrowTargets(int i, int from, int to) const;
+
+    Position position(int i) const;
+
+private:
+    void resetOne(int i);
+    void stepOne(int i, uint32_t action);
+    uint32_t sampleOne(int i);
+    void parallelFor(const std::function<void(int, int)>& fn) const;
+    void workerLoop(int id);
+
+    int count;
+    VecEnvOptions opts;
+
+    std::vector<Bitboard> amazonBuf[2];
+    std::vector<Bitboard> arrowBuf;
+    std::vector<uint8_t> sideBuf;
+    std::vector<uint16_t> plyBuf;
+    std::vector<uint64_t> rngBuf;
+
+    std::vector<float> rewardBuf;
+    std::vector<uint8_t> doneBuf;
+    std::vector<int8_t> winnerBuf;
+    std::vector<uint16_t> lengthBuf;
+
+    // 常驻线程池：每次 step 只唤醒，不创建线程 (const 的观测输出也用它并行)
+    std::vector<std::thread> workers;
+    mutable std::mutex poolMutex;
+    mutable std::condition_variable wake;
+    mutable std::condition_variable finished;
+    mutable const std::function<void(int, int)>* job = nullptr;
+    mutable uint64_t generation = 0;
+    mutable int pending = 0;
+    bool quit = false;
+};
+
+#endif // VECENV_H
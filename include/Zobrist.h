@@ -0,0 +1,42 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// --- Zobrist 哈希键 ---
+// 每个 (颜色, 格子) 的亚马逊、每个格子的箭以及"轮到蓝方"各有一个随机键，
+// 局面哈希为所有存在要素的键的异或，走子/射箭时可增量更新。
+
+namespace Zobrist {
+
+struct Keys {
+    uint64_t amazon[2][64];
+    uint64_t arrow[64];
+    uint64_t side; // 轮到蓝方 (0) 时异或
+
+    constexpr Keys() : amazon(), arrow(), side(0) {
+        // splitmix64，固定种子：哈希值跨进程、跨平台稳定 (开局库等文件依赖这一点)
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (int c = 0; c < 2; ++c)
+            for (int sq = 0; sq < 64; ++sq) amazon[c][sq] = next(state);
+        for (int sq = 0; sq < 64; ++sq) arrow[sq] = next(state);
+        side = next(state);
+    }
+
+    static constexpr uint64_t next(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+inline constexpr Keys keys;
+
+inline uint64_t amazon(int player, int sq) { return keys.amazon[player][sq]; }
+inline uint64_t arrow(int sq) { return keys.arrow[sq]; }
+inline uint64_t side() { return keys.side; }
+
+} // namespace Zobrist
+
+#endif // ZOBRIST_H
@@ -0,0 +1,100 @@
+#ifndef AICONTROLLER_H
+#define AICONTROLLER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMetaType>
+#include <atomic>
+#include <functional>
+#include "search_engine.h"
+
+Q_DECLARE_METATYPE(FullMove)
+
+/**
+ * @brief 后台思考 (pondering) 统计
+ */
+struct PonderStats {
+    quint64 attempts = 0;   // 后台思考期间对手完成走子的次数
+    quint64 hits = 0;       // 其中对手走法与预测一致的次数
+
+    double hitRate() const { return attempts ? double(hits) / double(attempts) : 0.0; }
+};
+
+/**
+ * @brief 在工作线程中运行 AI 搜索，GUI 线程只负责发起、取消和接收结果
+ *
+ * 每次搜索都有一个截止时间 (SearchLimits::timeMs)，到期后返回已找到的最佳走法；
+ * 取消是非阻塞的，被取消的搜索结果会被丢弃。
+ *
+ * 轮到对手时可以开始后台思考：预测对手最可能的走法，并在其后的局面上提前搜索。
+ * 对手实际走法与预测一致 (ponder hit) 时，startSearch 直接接管这次搜索，
+ * 已用掉的思考时间计入本回合预算；否则取消并重新搜索 (置换表仍然是热的)。
+ */
+class AiController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AiController(QObject *parent = nullptr);
+    ~AiController();
+
+    /**
+     * @brief 发起一次异步搜索 (若上一次搜索仍在进行，会先取消它)
+     * @return 是否命中后台思考 (命中时沿用正在进行的搜索)
+     */
+    bool startSearch(const Position &pos, int player, const SearchLimits &limits);
+
+    /**
+     * @brief 在对手思考期间开始后台思考
+     * @param pos 当前局面 (轮到 opponent 走)
+     * @param opponent 对手执棋方，AI 为 opponent ^ 1
+     * @param limits 命中后 AI 回合使用的限制 (timeMs 从后台思考开始时计时)
+     */
+    void startPondering(const Position &pos, int opponent, const SearchLimits &limits);
+
+    bool isPondering() const { return pondering; }
+    const PonderStats &ponderStats() const { return stats; }
+
+    /**
+     * @brief 取消当前搜索或后台思考并丢弃其结果 (不阻塞 GUI 线程)
+     */
+    void cancel();
+
+    /**
+     * @brief 取消当前搜索并等待工作线程退出 (关闭窗口时使用)
+     */
+    void cancelAndWait();
+
+    bool isSearching() const { return worker != nullptr; }
+
+    // 仅在没有搜索进行时修改配置 (线程数、置换表大小、后端等)
+    SearchEngine &engine() { return searchEngine; }
+
+signals:
+    void progress(int depth, int score, quint64 nodes, int elapsedMs);
+    void moveReady(const FullMove &move);
+
+    // 内部使用：由工作线程发出，排队回到 GUI 线程后再校验是否仍然有效
+    void searchFinished(quint64 ticket, const FullMove &move);
+
+private slots:
+    void onSearchFinished(quint64 ticket, const FullMove &move);
+
+private:
+    void launch(const std::function<void()> &job);
+
+    SearchEngine searchEngine;
+    QThread *worker = nullptr;
+    std::atomic<bool> cancelFlag{false};
+    quint64 ticket = 0;
+
+    // 后台思考状态：ponderKey 由工作线程在预测完成后写入，其余只在 GUI 线程访问
+    std::atomic<bool> ponderFlag{false};
+    std::atomic<quint64> ponderKey{0};
+    bool pondering = false;
+    bool ponderDone = false;     // 后台思考已自行结束 (如已找到必胜)，结果暂存
+    FullMove ponderResult;
+    PonderStats stats;
+};
+
+#endif // AICONTROLLER_H
@@ -9,6 +9,7 @@
 #include <QTimer>
 #include "AmazonEngine.h"
 #include "search_engine.h"
+#include "aicontroller.h"
 
 class MainWindow : public QMainWindow
 {
@@ -21,6 +22,9 @@ public:
     // 加载存档接口
     bool loadGame(const QString &filePath);
 
+    // 从对局日志恢复异常中断的对局 (模式以日志中的快照为准)
+    bool recoverGame(const QString &journalPath);
+
 protected:
     void closeEvent(QCloseEvent *event) override;
 
@@ -29,8 +33,11 @@ signals:
 
 private slots:
     void onUndo();
+    void onRedo();
     void onSaveGame();
     void runAITurn();
+    void onAIProgress(int depth, int score, quint64 nodes, int elapsedMs);
+    void onAIMoveReady(const FullMove &aiMove);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -38,7 +45,8 @@ protected:
 
 private:
     AmazonEngine engine;
-    SearchEngine aiEngine;
+    GameJournal journal;         // 每步追加写入的对局日志 (用于崩溃恢复)
+    AiController *aiController;  // AI 在工作线程中搜索，GUI 线程从不阻塞
     bool isPvE;
     bool aiThinking;
     
@@ -58,6 +66,8 @@ private:
     void drawHighlights(QPainter &painter);
     void showMessage(const QString &msg, bool isError = false);
     void updateTurnInfo();
+    void startPondering();
+    void startJournal();
 
     QLabel *statusLabel;
 };
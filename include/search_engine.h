@@ -1,10 +1,22 @@
 #ifndef SEARCH_ENGINE_H
 #define SEARCH_ENGINE_H
 
-#include "AmazonBoard.h"
 #include "GameLogic.h"
-#include <QVector>
-#include <QPair>
+#include "IncrementalEval.h"
+#include "MoveList.h"
+#include "MoveOrdering.h"
+#include "OpeningBook.h"
+#include "PnSolver.h"
+#include "Tablebase.h"
+#include "Position.h"
+#include "Symmetry.h"
+#include "TranspositionTable.h"
+#include "MctsEngine.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
 
 struct FullMove {
     Point from;
@@ -13,26 +25,218 @@ struct FullMove {
     double score;
 };
 
+/**
+ * @brief 可在运行时切换的搜索后端
+ */
+enum class SearchBackend {
+    AlphaBeta,  // 迭代加深 PVS + Lazy SMP (默认)
+    Mcts,       // 蒙特卡洛树搜索 (UCT)
+    Beam        // 旧版单层束搜索，仅作对比基线
+};
+
+/**
+ * @brief 搜索限制，0 表示不限制
+ */
+struct SearchLimits {
+    int maxDepth = 64;      // 迭代加深的最大深度 (以完整回合计)
+    uint64_t maxNodes = 0;  // 节点数上限 (MCTS 后端为模拟次数上限)
+    int timeMs = 0;         // 思考时间上限 (毫秒)，到期时返回已找到的最佳走法
+    const std::atomic<bool>* cancel = nullptr; // 外部取消标志 (可选)，置位后搜索尽快返回
+    // 后台思考标志 (可选)：置位期间忽略 timeMs；清零 (ponder hit) 后按自搜索开始起的
+    // 总耗时计时，因此对手思考得越久，清零后返回得越快
+    const std::atomic<bool>* ponder = nullptr;
+};
+
+/**
+ * @brief 最近一次搜索的结果 (迭代加深中已完成的最佳走法)
+ */
+struct SearchResult {
+    Move best = Move::none();
+    int score = 0;
+    int depth = 0;          // 已完成的深度
+    uint64_t nodes = 0;     // 搜索节点数 (MCTS 后端为模拟次数)
+    int elapsedMs = 0;
+    TTStats tt;             // 本次搜索的置换表统计
+    OrderingStats ordering; // 走法排序统计 (Alpha-Beta 后端，所有线程合计)
+    bool fromBook = false;  // 走法直接取自开局库 (未搜索)
+    // 残局证明数求解器的结论 (Alpha-Beta 后端)：必胜时 best 为证明树中的取胜走法
+    SolveStatus solved = SolveStatus::Unknown;
+    uint64_t solverNodes = 0;
+    // 本次 Alpha-Beta 搜索期间的堆分配次数 (所有搜索线程与残局求解器，不含首次创建线程
+    // 状态与启动线程本身)，仅在 AMAZONS_COUNT_ALLOCS 构建中统计，否则为 -1
+    int64_t allocations = -1;
+};
+
 class SearchEngine {
 public:
     SearchEngine();
 
+    // 将死分数：无子可动的一方判负
+    static constexpr int MATE_SCORE = 1000000;
+    static constexpr int INF_SCORE = MATE_SCORE + 1;
+    // 区域已分隔、胜负已定的局面 (Regions::decide)：DECIDED_SCORE 加上步数差
+    static constexpr int DECIDED_SCORE = MATE_SCORE / 2;
+    static constexpr int MAX_PLY = 64;
+    static_assert(MAX_PLY <= IncrementalEval::MAX_DEPTH, "IncrementalEval undo stack must cover the search depth");
+
     /**
-     * @brief 获取 AI 的最佳走法
-     * @param board 当前盘面
+     * @brief 获取 AI 的最佳走法 (使用默认的时间预算)
+     * @param pos 当前局面 (界面的 AmazonBoard 通过 toPosition() 转换)
      * @param player AI 执棋方 (0 or 1)
      * @return 最佳走法
      */
-    FullMove getBestMove(const AmazonBoard& board, int player);
+    FullMove getBestMove(const Position& pos, int player);
+
+    /**
+     * @brief 在给定深度/节点/时间限制下，用当前后端搜索最佳走法
+     */
+    FullMove getBestMove(const Position& pos, int player, const SearchLimits& limits);
+
+    /**
+     * @brief 预测 player 在该局面下最可能的走法 (用于后台思考)
+     *
+     * 优先取置换表中的最佳走法 (通常来自上一次搜索的主变例)，否则做一次浅层搜索。
+     * 无子可动或被取消时返回 Move::none()。
+     */
+    Move predictReply(const Position& pos, int player, const std::atomic<bool>* cancel = nullptr);
+
+    /**
+     * @brief 旧版单层束搜索 (保留作为对比基线)
+     */
+    FullMove getBeamMove(const Position& pos, int player);
+
+    const SearchResult& lastResult() const { return result; }
+
+    /**
+     * @brief 设置置换表大小 (MB)，会清空已有内容
+     */
+    void setHashSizeMB(size_t megabytes) { tt.resize(megabytes); }
+    void clearHash() { tt.clear(); }
+
+    /**
+     * @brief 映射孤立区域残局库 (tools/tbgen 生成)，文件不存在或无效时返回 false
+     * 加载后所有后端在双方分隔的局面上按查表得到的精确步数判定胜负
+     */
+    bool loadTablebase(const std::string& path);
+    const Tablebase::View* tablebaseView() const { return tablebase.isOpen() ? &tablebase.data() : nullptr; }
+
+    /**
+     * @brief 映射开局库 (tools/bookgen 生成)，文件不存在或无效时返回 false
+     *
+     * 加载后 getBestMove 在书中的局面上按权重随机选一个书中走法立即返回 (所有后端)，
+     * predictReply 取权重最大的书中走法。文件只做 mmap，启动时不解析
+     */
+    bool loadBook(const std::string& path);
+    void setBookEnabled(bool on) { useBook = on; }
+    bool bookEnabled() const { return useBook; }
+
+    /**
+     * @brief 残局证明数求解器 (默认开启)
+     *
+     * 双方可到达的空格不超过 PnSolver::MAX_SQUARES 时，Alpha-Beta 搜索期间在后台线程上
+     * 同时运行 df-pn；一旦证明必胜立即结束常规搜索并改走证明树中的取胜走法。求解器的
+     * 置换表跨回合保留，之后证明树内的局面直接查表落子，不再搜索。
+     */
+    void setSolverEnabled(bool on) { useSolver = on; }
+    bool solverEnabled() const { return useSolver; }
+    void setSolverHashMB(size_t megabytes);
+
+    // 置换表由所有搜索代码共享 (命中率统计也从这里读取)
+    TranspositionTable& transpositionTable() { return tt; }
+
+    /**
+     * @brief 设置搜索线程数 (Lazy SMP)，1 为单线程
+     */
+    void setThreads(int n);
+    int threads() const { return threadCount; }
+
+    /**
+     * @brief 切换搜索后端 (MCTS 的节点竞技场在首次使用时才分配)
+     */
+    void setBackend(SearchBackend b) { backend = b; }
+    SearchBackend currentBackend() const { return backend; }
+
+    /**
+     * @brief 设置随机种子 (MCTS 模拟使用)，相同种子单线程下结果可复现
+     */
+    void setSeed(uint64_t seed);
+
+    /**
+     * @brief 搜索进度回调：Alpha-Beta 每完成一轮迭代、MCTS 每隔约 100ms 调用一次
+     * 回调在搜索线程中执行
+     */
+    void setProgressCallback(std::function<void(const SearchResult&)> cb) { progressCallback = std::move(cb); }
+
+    // MCTS 后端的统计 (模拟次数/秒等)
+    MctsStats mctsStats() const { return mcts ? mcts->lastStats() : MctsStats(); }
+
+    // 默认思考时间 (毫秒)
+    static constexpr int DEFAULT_TIME_MS = 1000;
+    static constexpr int MAX_THREADS = 256;
+    // 箭不超过这个数的局面 (开局附近) 按对称规范化后再存取置换表；之后对称的局面很少出现，
+    // 直接使用增量维护的哈希
+    static constexpr int SYMMETRY_MAX_ARROWS = 8;
+    // predictReply 在置换表未命中时的浅层搜索限制
+    static constexpr int PREDICT_DEPTH = 2;
+    static constexpr int PREDICT_TIME_MS = 100;
 
 private:
-    double evaluate(const AmazonBoard& board, int player);
-    
-    // 蒙特卡洛模拟
-    double runMonteCarlo(AmazonBoard board, int player, int iterations);
-    
-    // 中心控制权重矩阵
-    int centerWeights[8][8];
+    /**
+     * @brief 每个搜索线程独占的状态
+     *
+     * 根节点走法列表是定长数组，随 ThreadData 一次性分配；内部节点由栈上的 MovePicker
+     * 分阶段生成走法，搜索过程中不再做堆分配
+     */
+    struct ThreadData {
+        int id = 0;
+        uint64_t nodes = 0;
+        MoveList rootMoves;
+        IncrementalEval eval;   // 与 pos 同步走子/撤销，叶子评估直接读取
+        MoveOrdering ordering;  // 历史表与杀手走法，跨回合保留 (每回合衰减)
+        OrderingStats orderingStats;
+        Move iterationBest = Move::none();
+        int iterationScore = 0;
+        Move best = Move::none();
+        int bestScore = 0;
+        int completedDepth = 0;
+    };
+
+    // --- Alpha-Beta (PVS, Lazy SMP) ---
+    FullMove searchAlphaBeta(const Position& pos, int player);
+    void iterativeDeepening(ThreadData& td, const Position& start);
+    int searchRoot(ThreadData& td, Position& pos, int depth, int alpha, int beta);
+    int search(ThreadData& td, Position& pos, int depth, int alpha, int beta, int ply);
+    void generateMoves(const Position& pos, MoveList& out, const MoveScorer& scorer, const Move& ttMove = Move::none());
+    static Symmetry::Key ttKey(const Position& pos);
+    static int scoreToTT(int score, int ply);
+    static int scoreFromTT(int score, int ply);
+    bool checkLimits(ThreadData& td);
+
+    FullMove toFullMove(const Move& m, double score) const;
+    // 主线程的走法排序表，也作为 MCTS 与束搜索的先验
+    MoveOrdering& mainOrdering();
+    void ensureThreadData(int count);
+
+    // 搜索状态 (所有线程共享)
+    TranspositionTable tt;
+    Tablebase::Table tablebase;
+    OpeningBook::Book book;
+    bool useBook = true;
+    uint64_t bookRandom;            // 书中走法的随机选择 (xorshift)，setSeed 后可复现
+    SearchLimits limits;
+    SearchResult result;
+    int threadCount = 1;
+    SearchBackend backend = SearchBackend::AlphaBeta;
+    uint64_t rngSeed = 0;
+    std::unique_ptr<MctsEngine> mcts;
+    std::unique_ptr<PnSolver> solver;   // 首次进入残局时才分配
+    size_t solverHashMB = PnSolver::DEFAULT_SIZE_MB;
+    bool useSolver = true;
+    std::function<void(const SearchResult&)> progressCallback;
+    std::atomic<bool> stopFlag{false};
+    std::atomic<uint64_t> totalNodes{0};
+    std::chrono::steady_clock::time_point startTime;
+    std::vector<std::unique_ptr<ThreadData>> threadData;
 };
 
 #endif // SEARCH_ENGINE_H
@@ -19,6 +19,7 @@ private slots:
     void onNewGame();
     void onLoadGame();
     void refreshSaveList();
+    void checkRecovery();
 
     // AI
     void onVsAI();
@@ -31,6 +32,7 @@ private:
     
     // 启动游戏窗口
     void launchGame(const QString &savePath = "", bool vsAI = false);
+    MainWindow *createGameWindow(bool vsAI);
 };
 
 #endif // STARTSCREEN_H
@@ -0,0 +1,42 @@
+#include "AllocCounter.h"
+
+#ifdef AMAZONS_COUNT_ALLOCS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> allocationCount{0};
+
+// 只需替换单个对象的版本：标准库默认的数组版本与 nothrow 版本都会转调它们
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace AllocCounter {
+
+bool enabled() { return true; }
+uint64_t allocations() { return allocationCount.load(std::memory_order_relaxed); }
+
+} // namespace AllocCounter
+
+#else
+
+namespace AllocCounter {
+
+bool enabled() { return false; }
+uint64_t allocations() { return 0; }
+
+} // namespace AllocCounter
+
+#endif
@@ -0,0 +1,48 @@
+#include "AmazonBoard.h"
+
+using namespace Bitboards;
+
+Position AmazonBoard::toPosition() const {
+    Position pos;
+    for (const auto& p : pieces) {
+        if (isOutOfBounds(p.col, p.row) || (p.user != 0 && p.user != 1)) continue;
+        pos.amazons[p.user] |= squareBB(squareOf(p.col, p.row));
+    }
+    for (const auto& b : blocks) {
+        if (isOutOfBounds(b.col, b.row)) continue;
+        pos.arrows |= squareBB(squareOf(b.col, b.row));
+    }
+    pos.sideToMove = currentPlayer;
+    pos.refreshHash();
+    return pos;
+}
+
+void AmazonBoard::applyPosition(const Position& pos) {
+    // 棋子：先红后蓝，与 AmazonEngine 构造时的顺序一致
+    pieces.clear();
+    for (int user = 1; user >= 0; --user) {
+        Bitboard b = pos.amazons[user];
+        while (b) {
+            int sq = popLsb(b);
+            pieces.push_back({colOf(sq), rowOf(sq), user});
+        }
+    }
+
+    // 障碍：保留仍然存在的旧障碍顺序，再追加新的
+    Bitboard remaining = pos.arrows;
+    QVector<Point> kept;
+    for (const auto& b : blocks) {
+        if (isOutOfBounds(b.col, b.row)) continue;
+        Bitboard bit = squareBB(squareOf(b.col, b.row));
+        if (remaining & bit) {
+            kept.push_back(b);
+            remaining &= ~bit;
+        }
+    }
+    while (remaining) {
+        int sq = popLsb(remaining);
+        kept.push_back({colOf(sq), rowOf(sq)});
+    }
+    blocks = kept;
+    currentPlayer = pos.sideToMove;
+}
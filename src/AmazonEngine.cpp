@@ -19,6 +19,10 @@ AmazonEngine::AmazonEngine() {
     currentBoard.pieces.push_back({5, 7, 0});
     currentBoard.pieces.push_back({0, 5, 0});
     currentBoard.pieces.push_back({7, 5, 0});
+
+    position = currentBoard.toPosition();
+    currentBoard.history.reset(position);
+    regions.reset(position);
 }
 
 // 对应原 exports.Movepiece
@@ -31,36 +35,28 @@ MoveResult AmazonEngine::movePiece(Point from, Point to) {
         return {false, "Game finished"};
 
     // 2. 查找棋子
-    int pIdx = -1;
-    for (int i = 0; i < currentBoard.pieces.size(); ++i) {
-        if (currentBoard.pieces[i].col == from.col && currentBoard.pieces[i].row == from.row) {
-            pIdx = i;
-            break;
-        }
-    }
+    int fromKey = GameLogic::getPosKey(from);
+    int toKey = GameLogic::getPosKey(to);
+    int user = position.pieceAt(fromKey);
 
-    if (pIdx == -1) return {false, "No piece here"};
-    if (currentBoard.pieces[pIdx].user != currentBoard.currentPlayer)
+    if (user == -1) return {false, "No piece here"};
+    if (user != currentBoard.currentPlayer)
         return {false, "Not your turn"};
 
-    // 存档 (History Snapshot) 用于悔棋功能
-    // 在移动棋子之前保存状态，这样悔棋可以回到“本回合开始前”
-    GameSnapshot snapshot;
-    snapshot.pieces = currentBoard.pieces;
-    snapshot.blocks = currentBoard.blocks;
-    snapshot.currentPlayer = currentBoard.currentPlayer;
-    snapshot.status = currentBoard.status;
-    snapshot.winner = currentBoard.winner;
-    currentBoard.history.push_back(snapshot);
-
     // 3. 走法校验 (调用之前写的 GameLogic)
     if (!GameLogic::isLineMove(from, to)) return {false, "Not a linear move"};
-    if (!GameLogic::isPathClear(from, to, currentBoard.pieces, currentBoard.blocks))
+    if (!GameLogic::isPathClear(from, to, position))
         return {false, "Path blocked"};
 
-    // 4. 执行移动
-    currentBoard.pieces[pIdx].col = to.col;
-    currentBoard.pieces[pIdx].row = to.row;
+    // 悔棋日志：校验通过后才记录走子前的状态 (箭在 placeArrow 中补上)
+    int priorWinner = currentBoard.winner.isValid() && !currentBoard.winner.isNull() ? currentBoard.winner.toInt() : -1;
+    currentBoard.history.push(PlyRecord::make(fromKey, toKey, currentBoard.status == "finished", priorWinner));
+
+    // 4. 执行移动 (位棋盘为准，同步到 UI 用的稀疏列表)
+    position.moveAmazon(user, fromKey, toKey);
+    regions.update(position, Bitboards::squareBB(fromKey) | Bitboards::squareBB(toKey));
+    movePieceEntry(from, to);
+    if (journal) journal->append(JournalOp::Move, fromKey, toKey);
 
     // 记录 Moves
     MoveRecord rec;
@@ -76,45 +72,159 @@ MoveResult AmazonEngine::movePiece(Point from, Point to) {
 MoveResult AmazonEngine::placeArrow(Point target) {
     if (!GameLogic::inBounds(target.col, target.row)) return {false, "Out of bounds"};
     
-    // 检查占用 (假设 currentBoard 有 isOccupied 方法)
-    if (currentBoard.isOccupied(target.col, target.row))
+    // 检查占用
+    int targetKey = GameLogic::getPosKey(target);
+    if (position.isOccupied(targetKey))
         return {false, "Position occupied"};
 
     // 放置障碍
+    position.placeArrow(targetKey);
+    regions.update(position, Bitboards::squareBB(targetKey));
     currentBoard.blocks.push_back(target);
     
-    // 切换玩家
-    int lastPlayer = currentBoard.currentPlayer;
-    currentBoard.currentPlayer = (currentBoard.currentPlayer == 1) ? 0 : 1;
-
-    // 胜负判定
-    int nextPlayer = currentBoard.currentPlayer;
-    bool canNextMove = GameLogic::canPlayerMove(nextPlayer, currentBoard.pieces, currentBoard.blocks);
-    bool canLastMove = GameLogic::canPlayerMove(lastPlayer, currentBoard.pieces, currentBoard.blocks);
+    // 切换玩家并判定胜负
+    int winner = switchTurn();
+    currentBoard.history.complete(targetKey, position);
+    if (journal) journal->append(JournalOp::Arrow, targetKey);
 
     MoveResult res = {true, "Shot successful"};
-    
-    // 判定逻辑：如果对手没法动了，当前射箭的人赢
-    if (!canNextMove) {
-        currentBoard.status = "finished";
-        currentBoard.winner = lastPlayer;
-        res.winner = lastPlayer;
+    if (winner != -1) {
+        res.winner = winner;
         res.message = "Game Over";
     }
 
     return res;
 }
 
+// 切换行棋方并判定胜负
+// @return 胜者，未分胜负时返回 -1
+int AmazonEngine::switchTurn() {
+    currentBoard.currentPlayer = (currentBoard.currentPlayer == 1) ? 0 : 1;
+    position.setSideToMove(currentBoard.currentPlayer);
+
+    int winner = decidedWinner();
+    if (winner != -1) {
+        currentBoard.status = "finished";
+        currentBoard.winner = winner;
+    }
+    return winner;
+}
+
+// 行棋方无子可动则对方获胜；双方已分隔且各自能走的步数足以定胜负时提前结束
+int AmazonEngine::decidedWinner() const {
+    if (!GameLogic::canPlayerMove(position.sideToMove, position)) return position.sideToMove ^ 1;
+    if (regions.separated()) {
+        Regions::Outcome outcome = Regions::decide(position);
+        if (outcome.decided) return outcome.winner;
+    }
+    return -1;
+}
+
+void AmazonEngine::movePieceEntry(Point from, Point to) {
+    for (auto& p : currentBoard.pieces) {
+        if (p.col == from.col && p.row == from.row) {
+            p.col = to.col;
+            p.row = to.row;
+            break;
+        }
+    }
+}
+
+void AmazonEngine::removeBlock(Point target) {
+    // 被撤销的箭通常就是最后放下的那一个
+    for (int i = currentBoard.blocks.size() - 1; i >= 0; --i) {
+        if (currentBoard.blocks[i] == target) {
+            currentBoard.blocks.remove(i);
+            break;
+        }
+    }
+}
+
 bool AmazonEngine::undo() {
-    if (currentBoard.history.isEmpty()) return false;
+    PlyRecord rec;
+    if (!currentBoard.history.undo(rec)) return false;
+
+    int user = position.pieceAt(rec.to);
+    if (rec.complete()) {
+        position.removeArrow(rec.arrow);
+        removeBlock(GameLogic::fromPosKey(rec.arrow));
+        currentBoard.currentPlayer = user;
+        position.setSideToMove(user);
+    }
+    position.moveAmazon(user, rec.to, rec.from);
+    regions.reset(position);
+    movePieceEntry(GameLogic::fromPosKey(rec.to), GameLogic::fromPosKey(rec.from));
 
-    const GameSnapshot& last = currentBoard.history.last();
-    currentBoard.pieces = last.pieces;
-    currentBoard.blocks = last.blocks;
-    currentBoard.currentPlayer = last.currentPlayer;
-    currentBoard.status = last.status;
-    currentBoard.winner = last.winner;
+    currentBoard.status = rec.priorFinished() ? "finished" : "playing";
+    currentBoard.winner = rec.priorWinner() >= 0 ? QVariant(rec.priorWinner()) : QVariant();
+    if (journal) journal->append(JournalOp::Undo);
+    return true;
+}
 
-    currentBoard.history.removeLast();
+bool AmazonEngine::redo() {
+    PlyRecord rec;
+    if (!currentBoard.history.redo(rec)) return false;
+
+    int user = position.pieceAt(rec.from);
+    position.moveAmazon(user, rec.from, rec.to);
+    movePieceEntry(GameLogic::fromPosKey(rec.from), GameLogic::fromPosKey(rec.to));
+    position.placeArrow(rec.arrow);
+    regions.update(position, Bitboards::squareBB(rec.from) | Bitboards::squareBB(rec.to) | Bitboards::squareBB(rec.arrow));
+    currentBoard.blocks.push_back(GameLogic::fromPosKey(rec.arrow));
+    switchTurn();
+    if (journal) journal->append(JournalOp::Redo);
     return true;
 }
+
+bool AmazonEngine::jumpToPly(int n) {
+    UndoLog& log = currentBoard.history;
+    if (n < 0 || n > log.completedPlies()) return false;
+
+    Position target = log.positionAt(n);
+    log.seek(n);
+    position = target;
+    regions.reset(position);
+    currentBoard.applyPosition(target);
+
+    // 对局状态由局面决定
+    int winner = decidedWinner();
+    if (winner == -1) {
+        currentBoard.status = "playing";
+        currentBoard.winner = QVariant();
+    } else {
+        currentBoard.status = "finished";
+        currentBoard.winner = winner;
+    }
+    if (journal) journal->append(JournalOp::Jump, n & 0xFF, n >> 8);
+    return true;
+}
+
+int AmazonEngine::replay(const std::vector<JournalEntry>& entries) {
+    GameJournal* saved = journal;
+    journal = nullptr;
+    int applied = 0;
+    for (const auto& e : entries) {
+        bool ok = false;
+        switch (e.type()) {
+        case JournalOp::Move:
+            ok = movePiece(GameLogic::fromPosKey(e.a), GameLogic::fromPosKey(e.b)).success;
+            break;
+        case JournalOp::Arrow:
+            ok = placeArrow(GameLogic::fromPosKey(e.a)).success;
+            break;
+        case JournalOp::Undo:
+            ok = undo();
+            break;
+        case JournalOp::Redo:
+            ok = redo();
+            break;
+        case JournalOp::Jump:
+            ok = jumpToPly(e.a | (e.b << 8));
+            break;
+        }
+        if (!ok) break;
+        ++applied;
+    }
+    journal = saved;
+    return applied;
+}
@@ -0,0 +1,166 @@
+#include "BinarySave.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "BinarySave assumes a little-endian host"
+#endif
+
+namespace BinarySave {
+
+static size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+static Position makePosition(uint64_t red, uint64_t blue, uint64_t arrows, int side) {
+    Position pos;
+    pos.amazons[1] = red;
+    pos.amazons[0] = blue;
+    pos.arrows = arrows;
+    pos.sideToMove = side;
+    pos.refreshHash();
+    return pos;
+}
+
+// 向前重放一条记录；未射箭的最后一回合只移动亚马逊，不换行棋方
+static void replay(Position& pos, const PlyRecord& r) {
+    if (r.complete()) pos.makeMove(r.move());
+    else pos.moveAmazon(pos.sideToMove, r.from, r.to);
+}
+
+std::vector<uint8_t> encode(const GameInfo& info, const Position& current,
+                            const UndoLog& history, bool checkpoints) {
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.headerSize = sizeof(Header);
+    h.mode = info.mode;
+    h.currentPlayer = info.currentPlayer;
+    h.status = info.status;
+    h.winner = info.winner;
+    h.plyCount = uint32_t(history.length());
+    h.plyCursor = uint32_t(history.ply());
+    h.idLength = uint32_t(info.id.size());
+    if (checkpoints) {
+        h.checkpointInterval = UndoLog::CHECKPOINT_INTERVAL;
+        h.checkpointCount = uint32_t(history.completedPlies() / UndoLog::CHECKPOINT_INTERVAL + 1);
+    }
+    h.amazons[0] = current.amazons[0];
+    h.amazons[1] = current.amazons[1];
+    h.arrows = current.arrows;
+
+    size_t idEnd = sizeof(Header) + align8(h.idLength);
+    size_t recordsEnd = idEnd + align8(h.plyCount * sizeof(PlyRecord));
+    std::vector<uint8_t> buf(recordsEnd + h.checkpointCount * sizeof(Checkpoint), 0);
+
+    std::memcpy(buf.data(), &h, sizeof(h));
+    std::memcpy(buf.data() + sizeof(Header), info.id.data(), h.idLength);
+    if (h.plyCount) std::memcpy(buf.data() + idEnd, history.entries().data(), h.plyCount * sizeof(PlyRecord));
+
+    for (uint32_t k = 0; k < h.checkpointCount; ++k) {
+        int ply = int(k * h.checkpointInterval);
+        Position pos = history.positionAt(ply);
+        Checkpoint c;
+        c.amazons[0] = pos.amazons[0];
+        c.amazons[1] = pos.amazons[1];
+        c.arrows = pos.arrows;
+        c.ply = uint32_t(ply);
+        c.sideToMove = uint32_t(pos.sideToMove);
+        std::memcpy(buf.data() + recordsEnd + k * sizeof(Checkpoint), &c, sizeof(c));
+    }
+    return buf;
+}
+
+bool write(const std::string& path, const GameInfo& info, const Position& current,
+           const UndoLog& history, bool checkpoints) {
+    std::vector<uint8_t> buf = encode(info, current, history, checkpoints);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(buf.data()), std::streamsize(buf.size()));
+    return bool(out);
+}
+
+bool isBinary(const uint8_t* data, size_t size) {
+    return data && size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool View::open(const uint8_t* data, size_t size) {
+    hdr = nullptr;
+    if (!isBinary(data, size) || size < sizeof(Header)) return false;
+    const Header* h = reinterpret_cast<const Header*>(data);
+    if (h->version != VERSION || h->headerSize != sizeof(Header)) return false;
+    if (h->plyCursor > h->plyCount) return false;
+    if (h->checkpointInterval == 0 && h->checkpointCount != 0) return false;
+    // 行棋方直接用作 Position::amazons 的下标，状态字段也只有这几种取值
+    if (h->mode > 1 || h->currentPlayer > 1 || h->status > 1 || h->winner < -1 || h->winner > 1) return false;
+
+    // 各段边界 (用 64 位计算，避免恶意头部导致溢出)
+    uint64_t idEnd = sizeof(Header) + align8(h->idLength);
+    uint64_t recordsEnd = idEnd + align8(uint64_t(h->plyCount) * sizeof(PlyRecord));
+    uint64_t end = recordsEnd + uint64_t(h->checkpointCount) * sizeof(Checkpoint);
+    if (end > size) return false;
+
+    // 检查点的行棋方同样用作下标，ply 决定从走子流的哪一项开始重放
+    const Checkpoint* cps = reinterpret_cast<const Checkpoint*>(data + recordsEnd);
+    for (uint32_t k = 0; k < h->checkpointCount; ++k) {
+        if (cps[k].sideToMove > 1 || cps[k].ply > h->plyCount
+            || uint64_t(cps[k].ply) != uint64_t(k) * h->checkpointInterval) return false;
+    }
+
+    // 走子流中的格子直接用作位棋盘移位量与 Zobrist 下标；未射箭的 -1 只允许出现在
+    // 最后一条且正处于游标位置 (与 UndoLog::rebuild 的规则一致)
+    const PlyRecord* rs = reinterpret_cast<const PlyRecord*>(data + idEnd);
+    auto inRange = [](int sq) { return sq >= 0 && sq < 64; };
+    for (uint32_t i = 0; i < h->plyCount; ++i) {
+        const PlyRecord& r = rs[i];
+        bool pendingOk = r.arrow == -1 && i + 1 == h->plyCount && h->plyCursor == h->plyCount;
+        if (!inRange(r.from) || !inRange(r.to) || !(inRange(r.arrow) || pendingOk)) return false;
+    }
+
+    hdr = h;
+    idBytes = reinterpret_cast<const char*>(data + sizeof(Header));
+    recs = reinterpret_cast<const PlyRecord*>(data + idEnd);
+    checkpoints = h->checkpointCount ? reinterpret_cast<const Checkpoint*>(data + recordsEnd) : nullptr;
+    return true;
+}
+
+std::string View::id() const {
+    return std::string(idBytes, hdr->idLength);
+}
+
+GameInfo View::info() const {
+    GameInfo info;
+    info.id = id();
+    info.mode = hdr->mode;
+    info.currentPlayer = hdr->currentPlayer;
+    info.status = hdr->status;
+    info.winner = hdr->winner;
+    return info;
+}
+
+Position View::current() const {
+    return makePosition(hdr->amazons[1], hdr->amazons[0], hdr->arrows, hdr->currentPlayer);
+}
+
+Position View::positionAt(int n) const {
+    int cur = cursor();
+    if (checkpoints) {
+        uint32_t k = uint32_t(n) / hdr->checkpointInterval;
+        if (k >= hdr->checkpointCount) k = hdr->checkpointCount - 1;
+        const Checkpoint& c = checkpoints[k];
+        Position pos = makePosition(c.amazons[1], c.amazons[0], c.arrows, int(c.sideToMove));
+        for (int i = int(c.ply); i < n; ++i) replay(pos, recs[i]);
+        return pos;
+    }
+
+    // 没有检查点：从游标处的局面向前撤销或向后重放
+    Position pos = current();
+    for (int i = cur - 1; i >= n; --i) {
+        const PlyRecord& r = recs[i];
+        if (r.complete()) pos.unmakeMove(r.move());
+        else pos.moveAmazon(pos.sideToMove, r.to, r.from);
+    }
+    for (int i = cur; i < n; ++i) replay(pos, recs[i]);
+    return pos;
+}
+
+} // namespace BinarySave
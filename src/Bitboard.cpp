@@ -0,0 +1,52 @@
+#include "Bitboard.h"
+
+namespace Bitboards {
+
+namespace {
+
+constexpr int dirCol[DirectionCount] = { 1, 0, 1, -1, -1, 0, -1, 1 };
+constexpr int dirRow[DirectionCount] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+// 编译期生成，不产生任何启动开销
+constexpr detail::RayTables makeTables() {
+    detail::RayTables t = {};
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int d = 0; d < DirectionCount; ++d) {
+            int c = colOf(sq) + dirCol[d];
+            int r = rowOf(sq) + dirRow[d];
+            if (c >= 0 && c < 8 && r >= 0 && r < 8) t.king[sq] |= squareBB(squareOf(c, r));
+            while (c >= 0 && c < 8 && r >= 0 && r < 8) {
+                t.rays[d][sq] |= squareBB(squareOf(c, r));
+                c += dirCol[d];
+                r += dirRow[d];
+            }
+        }
+    }
+    // between / beyond 表：沿每个方向，记录 from 到射线上每个点之间、以及该点之后的格子
+    for (int from = 0; from < 64; ++from) {
+        for (int d = 0; d < DirectionCount; ++d) {
+            Bitboard acc = 0;
+            int c = colOf(from) + dirCol[d];
+            int r = rowOf(from) + dirRow[d];
+            while (c >= 0 && c < 8 && r >= 0 && r < 8) {
+                int to = squareOf(c, r);
+                t.betweenBB[from][to] = acc;
+                t.beyondBB[from][to] = t.rays[d][to];
+                acc |= squareBB(to);
+                c += dirCol[d];
+                r += dirRow[d];
+            }
+        }
+    }
+    return t;
+}
+
+} // namespace
+
+namespace detail {
+
+constexpr RayTables tables = makeTables();
+
+} // namespace detail
+
+} // namespace Bitboards
@@ -0,0 +1,60 @@
+#include "Evaluation.h"
+#include "Territory.h"
+
+using namespace Bitboards;
+
+namespace Evaluation {
+
+namespace {
+
+// 8 - (int)到棋盘中心 (3.5, 3.5) 的欧氏距离
+constexpr int centerWeights[64] = {
+    4, 4, 5, 5, 5, 5, 4, 4,
+    4, 5, 6, 6, 6, 6, 5, 4,
+    5, 6, 6, 7, 7, 6, 6, 5,
+    5, 6, 7, 8, 8, 7, 6, 5,
+    5, 6, 7, 8, 8, 7, 6, 5,
+    5, 6, 6, 7, 7, 6, 6, 5,
+    4, 5, 6, 6, 6, 6, 5, 4,
+    4, 4, 5, 5, 5, 5, 4, 4
+};
+
+} // namespace
+
+int centerWeight(int sq) {
+    return centerWeights[sq];
+}
+
+int mobilityScore(const Position& pos, int player) {
+    int score = 0;
+
+    // 1. 灵活性 (Mobility) - 简单计算每个棋子的可移动步数
+    int myMobility = 0;
+    int oppMobility = 0;
+    Bitboard occ = pos.occupied();
+
+    for (int user = 0; user < 2; ++user) {
+        Bitboard pieces = pos.amazons[user];
+        while (pieces) {
+            int sq = popLsb(pieces);
+            int moves = popCount(queenAttacks(sq, occ));
+            if (user == player) {
+                myMobility += moves;
+                // 2. 中心控制 (Center Control) - 前期权重较大
+                score += centerWeights[sq];
+            } else {
+                oppMobility += moves;
+                score -= centerWeights[sq];
+            }
+        }
+    }
+
+    score += 2 * (myMobility - oppMobility);
+    return score;
+}
+
+int evaluate(const Position& pos, int player) {
+    return mobilityScore(pos, player) + Territory::evaluate(pos, player);
+}
+
+} // namespace Evaluation
@@ -0,0 +1,196 @@
+#include "GameJournal.h"
+#include "MappedFile.h"
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char JOURNAL_MAGIC[4] = {'A', 'M', 'Z', 'J'};
+static const uint16_t JOURNAL_VERSION = 1;
+
+static size_t align4(size_t n) { return (n + 3) & ~size_t(3); }
+
+#ifdef _WIN32
+static std::wstring widen(const std::string& path) {
+    int len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring w(len > 0 ? size_t(len) : 1, L'\0');
+    if (len > 0) MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &w[0], len);
+    return w;
+}
+static std::FILE* openForWrite(const std::string& path) { return _wfopen(widen(path).c_str(), L"wb"); }
+static void removeFile(const std::string& path) { _wremove(widen(path).c_str()); }
+static bool syncFile(std::FILE* f) { return _commit(_fileno(f)) == 0; }
+#else
+static std::FILE* openForWrite(const std::string& path) { return std::fopen(path.c_str(), "wb"); }
+static void removeFile(const std::string& path) { std::remove(path.c_str()); }
+static bool syncFile(std::FILE* f) { return fsync(fileno(f)) == 0; }
+#endif
+
+bool GameJournal::open(const std::string& path, const std::vector<uint8_t>& snapshot, const JournalOptions& options) {
+    close();
+    file = openForWrite(path);
+    if (!file) return false;
+    filePath = path;
+    opts = options;
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, JOURNAL_MAGIC, sizeof(h.magic));
+    h.version = JOURNAL_VERSION;
+    h.snapshotSize = uint32_t(snapshot.size());
+
+    // 头部与快照同样交给写线程，open 本身不做文件写入
+    pending.assign(align4(sizeof(Header) + snapshot.size()), 0);
+    std::memcpy(pending.data(), &h, sizeof(h));
+    if (!snapshot.empty()) std::memcpy(pending.data() + sizeof(Header), snapshot.data(), snapshot.size());
+    appendedBytes = pending.size();
+    durableBytes = 0;
+    flushWaiters = 0;
+    stopping = false;
+    writeFailed = false;
+    syncs = 0;
+
+    writer = std::thread(&GameJournal::writerLoop, this);
+    return true;
+}
+
+void GameJournal::append(JournalOp op, int a, int b) {
+    if (!file) return;
+    JournalEntry e = JournalEntry::make(op, a, b);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&e);
+        pending.insert(pending.end(), bytes, bytes + sizeof(e));
+        appendedBytes += sizeof(e);
+    }
+    wakeWriter.notify_one();
+}
+
+void GameJournal::flush() {
+    if (!file) return;
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t target = appendedBytes;
+    if (durableBytes >= target) return;
+    ++flushWaiters;
+    wakeWriter.notify_one();
+    written.wait(lock, [&] { return durableBytes >= target; });
+    --flushWaiters;
+}
+
+void GameJournal::close() {
+    if (!file) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWriter.notify_one();
+    writer.join();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void GameJournal::discard() {
+    close();
+    if (!filePath.empty()) removeFile(filePath);
+    filePath.clear();
+}
+
+bool GameJournal::failed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writeFailed;
+}
+
+uint64_t GameJournal::syncCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncs;
+}
+
+void GameJournal::writerLoop() {
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(opts.syncIntervalMs);
+    std::vector<uint8_t> batch;
+    bool dirty = false;                 // 已写出但尚未 fsync
+    Clock::time_point lastSync = Clock::now() - interval;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        auto ready = [&] { return !pending.empty() || stopping || (flushWaiters > 0 && dirty); };
+        // 批量策略下有未同步的数据时，最迟在截止时间醒来同步
+        if (dirty && opts.durability == JournalDurability::Batched)
+            wakeWriter.wait_until(lock, lastSync + interval, ready);
+        else
+            wakeWriter.wait(lock, ready);
+
+        batch.swap(pending);
+        uint64_t target = appendedBytes;
+        bool forceSync = stopping || flushWaiters > 0;
+        bool stop = stopping;
+        lock.unlock();
+
+        bool ok = true;
+        if (!batch.empty()) {
+            ok = std::fwrite(batch.data(), 1, batch.size(), file) == batch.size() && std::fflush(file) == 0;
+            batch.clear();
+            dirty = true;
+        }
+
+        bool syncNow = false;
+        if (dirty) {
+            switch (opts.durability) {
+            case JournalDurability::EveryWrite:
+                syncNow = true;
+                break;
+            case JournalDurability::Batched:
+                syncNow = forceSync || Clock::now() - lastSync >= interval;
+                break;
+            case JournalDurability::None:
+                dirty = false; // fflush 之后交由操作系统决定落盘时机
+                break;
+            }
+        }
+        if (syncNow) {
+            ok = syncFile(file) && ok;
+            dirty = false;
+            lastSync = Clock::now();
+        }
+
+        lock.lock();
+        if (!ok) writeFailed = true;
+        if (syncNow) ++syncs;
+        if (!dirty) {
+            durableBytes = target;
+            written.notify_all();
+        }
+        if (stop && pending.empty()) break;
+    }
+}
+
+bool GameJournal::read(const std::string& path, std::vector<uint8_t>& snapshot, std::vector<JournalEntry>& entries) {
+    snapshot.clear();
+    entries.clear();
+
+    MappedFile mapped;
+    if (!mapped.open(path) || mapped.size() < sizeof(Header)) return false;
+    Header h;
+    std::memcpy(&h, mapped.data(), sizeof(h));
+    if (std::memcmp(h.magic, JOURNAL_MAGIC, sizeof(h.magic)) != 0 || h.version != JOURNAL_VERSION) return false;
+    if (uint64_t(sizeof(Header)) + h.snapshotSize > mapped.size()) return false;
+
+    const uint8_t* data = mapped.data();
+    snapshot.assign(data + sizeof(Header), data + sizeof(Header) + h.snapshotSize);
+
+    size_t offset = align4(sizeof(Header) + h.snapshotSize);
+    while (offset + sizeof(JournalEntry) <= mapped.size()) {
+        JournalEntry e;
+        std::memcpy(&e, data + offset, sizeof(e));
+        if (!e.valid()) break;
+        entries.push_back(e);
+        offset += sizeof(e);
+    }
+    return true;
+}
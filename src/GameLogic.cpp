@@ -12,44 +12,16 @@ bool GameLogic::isLineMove(Point from, Point to) {
     return (dr == 0 || dc == 0 || dr == dc);
 }
 
-std::set<int> GameLogic::getOccupiedPositions(const QVector<Piece>& pieces, const QVector<Point>& blocks) {
-    std::set<int> occupied;
-    for (const auto& p : pieces) occupied.insert(getPosKey(p.col, p.row));
-    for (const auto& b : blocks) occupied.insert(getPosKey(b.col, b.row));
-    return occupied;
+bool GameLogic::isPathClear(Point from, Point to, const Position& pos) {
+    if (!inBounds(from.col, from.row) || !inBounds(to.col, to.row) || !isLineMove(from, to)) return false;
+
+    // 路径 (不含起点) 与终点都必须为空
+    int f = getPosKey(from);
+    int t = getPosKey(to);
+    Bitboard path = Bitboards::between(f, t) | Bitboards::squareBB(t);
+    return (path & pos.occupied()) == 0;
 }
 
-bool GameLogic::isPathClear(Point from, Point to, const QVector<Piece>& pieces, const QVector<Point>& blocks) {
-    if (!inBounds(to.col, to.row) || !isLineMove(from, to)) return false;
-
-    int stepR = (to.row == from.row) ? 0 : (to.row - from.row) / std::abs(to.row - from.row);
-    int stepC = (to.col == from.col) ? 0 : (to.col - from.col) / std::abs(to.col - from.col);
-
-    auto occupied = getOccupiedPositions(pieces, blocks);
-
-    int r = from.row + stepR;
-    int c = from.col + stepC;
-
-    while (true) {
-        if (occupied.count(getPosKey(c, r))) return false;
-        if (r == to.row && c == to.col) break;
-        r += stepR;
-        c += stepC;
-    }
-    return true;
+bool GameLogic::canPlayerMove(int player, const Position& pos) {
+    return pos.canMove(player);
 }
-
-bool GameLogic::canPlayerMove(int player, const QVector<Piece>& pieces, const QVector<Point>& blocks) {
-    static const int dirs[8][2] = {{1,1},{1,0},{1,-1},{0,1},{0,-1},{-1,1},{-1,0},{-1,-1}};
-    auto occupied = getOccupiedPositions(pieces, blocks);
-
-    for (const auto& piece : pieces) {
-        if (piece.user != player) continue;
-        for (int i = 0; i < 8; ++i) {
-            int nc = piece.col + dirs[i][0];
-            int nr = piece.row + dirs[i][1];
-            if (inBounds(nc, nr) && !occupied.count(getPosKey(nc, nr))) return true;
-        }
-    }
-    return false;
-}
\ No newline at end of file
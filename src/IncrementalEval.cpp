@@ -0,0 +1,123 @@
+#include "IncrementalEval.h"
+#include "Evaluation.h"
+#include <cstring>
+
+using namespace Bitboards;
+
+void IncrementalEval::reset(const Position& pos) {
+    std::memset(&st, 0, sizeof(st));
+    st.amazons[0] = pos.amazons[0];
+    st.amazons[1] = pos.amazons[1];
+    st.occupied = pos.occupied();
+    st.sideToMove = pos.sideToMove;
+    depth = 0;
+
+    for (int user = 0; user < 2; ++user) {
+        Bitboard pieces = pos.amazons[user];
+        while (pieces && st.count < MAX_PIECES) {
+            int sq = popLsb(pieces);
+            int i = st.count++;
+            st.square[i] = int8_t(sq);
+            st.owner[i] = int8_t(user);
+            add(i, queenAttacks(sq, st.occupied));
+            st.center[user] += Evaluation::centerWeight(sq);
+        }
+    }
+}
+
+// 位切片计数器加减：span 中每个格子的计数同时 +1 / -1 (逐位传递进位/借位)
+void IncrementalEval::add(int i, Bitboard span) {
+    Bitboard* r = st.reach[st.owner[i]];
+    st.attacks[i] |= span;
+    st.mobility[st.owner[i]] += popCount(span);
+    Bitboard c0 = r[0] & span;
+    r[0] ^= span;
+    Bitboard c1 = r[1] & c0;
+    r[1] ^= c0;
+    r[2] ^= c1;
+}
+
+void IncrementalEval::remove(int i, Bitboard span) {
+    Bitboard* r = st.reach[st.owner[i]];
+    st.attacks[i] &= ~span;
+    st.mobility[st.owner[i]] -= popCount(span);
+    Bitboard b0 = ~r[0] & span;
+    r[0] ^= span;
+    Bitboard b1 = ~r[1] & b0;
+    r[1] ^= b0;
+    r[2] ^= b1;
+}
+
+void IncrementalEval::vacate(int sq) {
+    // 沿各方向最近的占用格若是亚马逊，其射线越过 sq 延伸到反方向的下一个占用格之前
+    const Bitboard pieces = st.amazons[0] | st.amazons[1];
+    for (int d = 0; d < DirectionCount; ++d) {
+        Bitboard blockers = ray(d, sq) & st.occupied;
+        if (!blockers) continue;
+        int piece = d < West ? lsb(blockers) : msb(blockers);
+        if (!(pieces & squareBB(piece))) continue;
+        for (int i = 0; i < st.count; ++i) {
+            if (st.square[i] == piece) {
+                add(i, squareBB(sq) | slideAttacks((d + 4) & 7, sq, st.occupied));
+                break;
+            }
+        }
+    }
+}
+
+void IncrementalEval::block(int sq) {
+    // 能到达 sq 的亚马逊失去 sq 及其后的一段
+    const Bitboard sqBB = squareBB(sq);
+    for (int i = 0; i < st.count; ++i) {
+        if (st.attacks[i] & sqBB)
+            remove(i, sqBB | (st.attacks[i] & beyond(st.square[i], sq)));
+    }
+}
+
+void IncrementalEval::moveAmazon(int player, int from, int to) {
+    int mover = 0;
+    while (mover < st.count && st.square[mover] != from) ++mover;
+    if (mover == st.count) return;
+
+    // 先撤掉移动的亚马逊，使其不参与起点/落点两处的射线更新
+    remove(mover, st.attacks[mover]);
+    st.amazons[player] ^= squareBB(from);
+    st.occupied ^= squareBB(from);
+    st.square[mover] = -1;
+    vacate(from);
+
+    block(to);
+    st.amazons[player] ^= squareBB(to);
+    st.occupied ^= squareBB(to);
+    st.square[mover] = int8_t(to);
+    add(mover, queenAttacks(to, st.occupied));
+
+    st.center[player] += Evaluation::centerWeight(to) - Evaluation::centerWeight(from);
+}
+
+void IncrementalEval::placeArrow(int sq) {
+    block(sq);
+    st.occupied |= squareBB(sq);
+}
+
+void IncrementalEval::removeArrow(int sq) {
+    st.occupied &= ~squareBB(sq);
+    vacate(sq);
+}
+
+bool IncrementalEval::matches(const Position& pos) const {
+    IncrementalEval fresh(pos);
+    if (fresh.st.amazons[0] != st.amazons[0] || fresh.st.amazons[1] != st.amazons[1]
+        || fresh.st.occupied != st.occupied || fresh.st.count != st.count
+        || std::memcmp(fresh.st.reach, st.reach, sizeof(st.reach)) != 0)
+        return false;
+    for (int user = 0; user < 2; ++user) {
+        if (fresh.st.mobility[user] != st.mobility[user] || fresh.st.center[user] != st.center[user])
+            return false;
+    }
+    // 亚马逊的编号顺序随走子变化，按格子比较
+    for (int i = 0; i < st.count; ++i) {
+        if (fresh.pieceAttacks(st.square[i]) != st.attacks[i]) return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (wlen <= 0) return false;
+    std::wstring wpath(size_t(wlen), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], wlen);
+
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE map = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // 映射对象持有文件引用
+    if (!map) return false;
+
+    void* view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(map);
+        return false;
+    }
+    base = view;
+    mapping = map;
+    length = size_t(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle(mapping);
+    base = nullptr;
+    mapping = nullptr;
+    length = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // 映射建立后即可关闭描述符
+    if (view == MAP_FAILED) return false;
+
+    base = view;
+    length = size_t(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (base) munmap(base, length);
+    base = nullptr;
+    length = 0;
+}
+
+#endif
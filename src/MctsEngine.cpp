@@ -0,0 +1,369 @@
+#include "MctsEngine.h"
+#include "Evaluation.h"
+#include "MoveOrdering.h"
+#include "Regions.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace Bitboards;
+
+namespace {
+
+// 一个节点最多的子动作数：4 个亚马逊 × 每个最多 27 个落点
+const int MAX_CHILDREN = 128;
+
+// UCT 探索常数与渐进展宽系数：允许的子节点数 = 1 + PW_COEF * sqrt(访问次数)
+const double UCT_C = 0.7;
+const double PW_COEF = 1.5;
+
+// 节点第二次被访问时才展开 (根节点除外)
+const uint32_t EXPAND_VISITS = 2;
+
+// 随机模拟的完整回合数，之后用静态评估收尾
+const int PLAYOUT_MOVES = 8;
+// 评估分 → 胜率的 logistic 缩放
+const double EVAL_SCALE = 24.0;
+// 历史分 (至多 ±HISTORY_MAX) 折算到先验的比例：满分折合 32 分，相当于 16 步灵活性
+const int HISTORY_PRIOR_DIV = MoveOrdering::HISTORY_MAX / 32;
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 插入排序 (动作数很少，且避免堆分配)
+void sortByPrior(int8_t* a, int8_t* b, int* prior, int n) {
+    for (int i = 1; i < n; ++i) {
+        int8_t ka = a[i], kb = b[i];
+        int kp = prior[i];
+        int j = i - 1;
+        while (j >= 0 && prior[j] < kp) {
+            a[j + 1] = a[j];
+            b[j + 1] = b[j];
+            prior[j + 1] = prior[j];
+            --j;
+        }
+        a[j + 1] = ka;
+        b[j + 1] = kb;
+        prior[j + 1] = kp;
+    }
+}
+
+// 走子先验：落点的灵活性 + 中心权重
+int queenPrior(const Position& pos, int from, int to) {
+    Bitboard occ = pos.occupied() ^ squareBB(from);
+    return 2 * popCount(queenAttacks(to, occ)) + Evaluation::centerWeight(to);
+}
+
+// 射箭先验：贴近对方亚马逊 (封堵) 加分，贴近己方亚马逊扣分
+int arrowPrior(const Position& pos, int side, int arrow) {
+    Bitboard around = kingAttacks(arrow);
+    return 4 * popCount(around & pos.amazons[side ^ 1])
+         - 2 * popCount(around & pos.amazons[side])
+         + Evaluation::centerWeight(arrow) / 2;
+}
+
+} // namespace
+
+MctsEngine::MctsEngine(size_t maxNodes) {
+    setArenaSize(maxNodes);
+}
+
+void MctsEngine::setArenaSize(size_t maxNodes) {
+    if (maxNodes < MAX_CHILDREN + 1) maxNodes = MAX_CHILDREN + 1;
+    nodes.reset(new Node[maxNodes]);
+    capacity = maxNodes;
+    used.store(0);
+}
+
+uint32_t MctsEngine::allocate(uint32_t count) {
+    if (used.load(std::memory_order_relaxed) + count > capacity) return 0;
+    uint32_t first = used.fetch_add(count, std::memory_order_relaxed);
+    if (size_t(first) + count > capacity) return 0; // 竞技场已满 (0 号是根，不会作为子节点)
+    return first;
+}
+
+int MctsEngine::randomSquare(Bitboard b, Rng& rng) {
+    int n = rng.bounded(popCount(b));
+    while (n-- > 0) b &= b - 1;
+    return lsb(b);
+}
+
+// 展开一个节点：生成全部子动作，按先验排序后一次性分配在竞技场的连续区域
+// pendingTo >= 0 表示该节点已走子、尚待射箭 (子节点为射箭动作)
+bool MctsEngine::expand(uint32_t idx, const Position& pos, int pendingTo) {
+    Node& node = nodes[idx];
+    int side = pos.sideToMove;
+    int8_t a[MAX_CHILDREN], b[MAX_CHILDREN];
+    int prior[MAX_CHILDREN];
+    int n = 0;
+
+    if (pendingTo >= 0) {
+        Bitboard arrows = pos.reachable(pendingTo);
+        while (arrows && n < MAX_CHILDREN) {
+            int ar = popLsb(arrows);
+            a[n] = -1;
+            b[n] = int8_t(ar);
+            prior[n] = arrowPrior(pos, side, ar);
+            if (ordering) prior[n] += ordering->arrowHistory(side, ar) / HISTORY_PRIOR_DIV;
+            ++n;
+        }
+    } else {
+        Bitboard mine = pos.amazons[side];
+        while (mine) {
+            int from = popLsb(mine);
+            Bitboard targets = pos.reachable(from);
+            while (targets && n < MAX_CHILDREN) {
+                int to = popLsb(targets);
+                a[n] = int8_t(from);
+                b[n] = int8_t(to);
+                prior[n] = queenPrior(pos, from, to);
+                if (ordering) prior[n] += ordering->queenHistory(side, from, to) / HISTORY_PRIOR_DIV;
+                ++n;
+            }
+        }
+    }
+    if (n == 0) return false;
+
+    sortByPrior(a, b, prior, n);
+    uint32_t first = allocate(uint32_t(n));
+    if (first == 0) return false;
+
+    for (int i = 0; i < n; ++i) {
+        Node& child = nodes[first + i];
+        child.visits.store(0, std::memory_order_relaxed);
+        child.value.store(0, std::memory_order_relaxed);
+        child.firstChild.store(0, std::memory_order_relaxed);
+        child.state.store(0, std::memory_order_relaxed);
+        child.childCount = 0;
+        child.from = a[i];
+        child.to = b[i];
+        child.player = uint8_t(side);
+        child.arrowLevel = pendingTo < 0; // 走子动作的子节点是射箭动作
+    }
+    node.firstChild.store(first, std::memory_order_relaxed);
+    node.childCount = uint16_t(n);
+    return true;
+}
+
+// UCT 选择，只在渐进展宽允许的前若干个 (按先验排序的) 子节点中挑选
+uint32_t MctsEngine::selectChild(const Node& node) const {
+    uint32_t parentVisits = node.visits.load(std::memory_order_relaxed);
+    int allowed = 1 + int(PW_COEF * std::sqrt(double(parentVisits)));
+    if (allowed > node.childCount) allowed = node.childCount;
+
+    uint32_t first = node.firstChild.load(std::memory_order_relaxed);
+    double logN = std::log(double(parentVisits) + 1.0);
+    uint32_t best = first;
+    double bestScore = -1.0;
+    for (int i = 0; i < allowed; ++i) {
+        const Node& child = nodes[first + i];
+        uint32_t v = child.visits.load(std::memory_order_relaxed);
+        if (v == 0) return first + i; // 先验顺序中第一个未访问的
+        double q = double(child.value.load(std::memory_order_relaxed)) / (double(v) * VALUE_SCALE);
+        double score = q + UCT_C * std::sqrt(logN / v);
+        if (score > bestScore) {
+            bestScore = score;
+            best = first + i;
+        }
+    }
+    return best;
+}
+
+// 随机模拟若干回合后用静态评估收尾，返回红方 (1) 的胜率估计
+double MctsEngine::playout(Position pos, int pendingTo, Rng& rng) const {
+    int side = pos.sideToMove;
+    if (pendingTo >= 0) {
+        pos.placeArrow(randomSquare(pos.reachable(pendingTo), rng));
+        side ^= 1;
+    }
+
+    for (int d = 0; d < PLAYOUT_MOVES; ++d) {
+        if (!pos.canMove(side)) return side == 1 ? 0.0 : 1.0;
+
+        // 随机选择一个还能动的亚马逊
+        Bitboard empty = pos.empty();
+        Bitboard movable = 0;
+        Bitboard mine = pos.amazons[side];
+        while (mine) {
+            int sq = popLsb(mine);
+            if (kingAttacks(sq) & empty) movable |= squareBB(sq);
+        }
+        int from = randomSquare(movable, rng);
+        int to = randomSquare(pos.reachable(from), rng);
+        pos.moveAmazon(side, from, to);
+        pos.placeArrow(randomSquare(pos.reachable(to), rng));
+        side ^= 1;
+    }
+
+    // 双方已分隔且胜负已定时直接给出确定的结果
+    pos.sideToMove = side;
+    Regions::Outcome outcome = Regions::decide(pos, tablebase);
+    if (outcome.decided) return outcome.winner == 1 ? 1.0 : 0.0;
+
+    int eval = Evaluation::evaluate(pos, 1);
+    return 1.0 / (1.0 + std::exp(-eval / EVAL_SCALE));
+}
+
+void MctsEngine::worker(int id, const Position& root) {
+    Rng rng{seed ^ (0x9E3779B97F4A7C15ULL * uint64_t(id + 1))};
+    uint32_t path[MAX_DEPTH];
+    int64_t nextReport = startMs + 100;
+
+    while (!stopFlag.load(std::memory_order_relaxed)) {
+        uint64_t done = playouts.fetch_add(1, std::memory_order_relaxed);
+        if (playoutLimit && done >= playoutLimit) {
+            stopFlag.store(true, std::memory_order_relaxed);
+            break;
+        }
+        if ((done & 63) == 0) {
+            int64_t now = nowMs();
+            bool pondering = ponderFlag && ponderFlag->load(std::memory_order_relaxed);
+            if ((timeLimitMs && !pondering && now - startMs >= timeLimitMs)
+                || (cancelFlag && cancelFlag->load(std::memory_order_relaxed))) {
+                stopFlag.store(true, std::memory_order_relaxed);
+                break;
+            }
+            if (id == 0 && progressCallback && now >= nextReport) {
+                MctsStats st;
+                st.playouts = done;
+                st.treeNodes = used.load(std::memory_order_relaxed);
+                st.elapsedMs = int(now - startMs);
+                progressCallback(st);
+                nextReport = now + 100;
+            }
+        }
+
+        Position pos = root;
+        int pendingTo = -1;
+        int depth = 0;
+        uint32_t idx = 0;
+        double redValue = -1.0;
+
+        while (true) {
+            Node& node = nodes[idx];
+            uint32_t visits = node.visits.fetch_add(1, std::memory_order_relaxed) + 1; // 虚拟损失
+            path[depth++] = idx;
+
+            if (pendingTo < 0 && !pos.canMove(pos.sideToMove)) {
+                redValue = pos.sideToMove == 1 ? 0.0 : 1.0; // 终局：行棋方无子可动
+                break;
+            }
+
+            uint8_t st = node.state.load(std::memory_order_acquire);
+            if (st != 2) {
+                uint8_t expected = 0;
+                bool mayExpand = idx == 0 || visits >= EXPAND_VISITS;
+                if (st == 0 && mayExpand && node.state.compare_exchange_strong(expected, 1)) {
+                    if (!expand(idx, pos, pendingTo)) {
+                        node.state.store(0, std::memory_order_release); // 竞技场已满，作为叶子
+                        break;
+                    }
+                    node.state.store(2, std::memory_order_release);
+                } else {
+                    break; // 叶子 (或其他线程正在展开)
+                }
+            }
+            if (depth >= MAX_DEPTH) break;
+
+            uint32_t c = selectChild(node);
+            const Node& child = nodes[c];
+            if (pendingTo < 0) {
+                pos.moveAmazon(pos.sideToMove, child.from, child.to);
+                pendingTo = child.to;
+            } else {
+                pos.placeArrow(child.to);
+                pos.setSideToMove(pos.sideToMove ^ 1);
+                pendingTo = -1;
+            }
+            idx = c;
+        }
+
+        if (redValue < 0.0) redValue = playout(pos, pendingTo, rng);
+
+        for (int i = 0; i < depth; ++i) {
+            Node& node = nodes[path[i]];
+            double v = node.player == 1 ? redValue : 1.0 - redValue;
+            node.value.fetch_add(uint64_t(v * VALUE_SCALE + 0.5), std::memory_order_relaxed);
+        }
+    }
+}
+
+// 取访问次数最多的走子，再取其下访问次数最多的射箭；
+// 若该走子尚未展开射箭层，则按射箭先验挑选
+Move MctsEngine::bestMove(const Position& root) const {
+    const Node& rootNode = nodes[0];
+    if (rootNode.state.load(std::memory_order_acquire) != 2) return Move::none();
+
+    auto mostVisited = [this](const Node& n) {
+        uint32_t first = n.firstChild.load(std::memory_order_relaxed);
+        uint32_t best = first;
+        for (uint32_t i = first; i < first + n.childCount; ++i) {
+            if (nodes[i].visits.load(std::memory_order_relaxed) > nodes[best].visits.load(std::memory_order_relaxed))
+                best = i;
+        }
+        return best;
+    };
+
+    const Node& q = nodes[mostVisited(rootNode)];
+    Move m = {q.from, q.to, -1};
+    if (q.state.load(std::memory_order_acquire) == 2) {
+        m.arrow = nodes[mostVisited(q)].to;
+    } else {
+        Position pos = root;
+        pos.moveAmazon(pos.sideToMove, q.from, q.to);
+        Bitboard arrows = pos.reachable(q.to);
+        int bestPrior = -1000000;
+        while (arrows) {
+            int ar = popLsb(arrows);
+            int p = arrowPrior(pos, pos.sideToMove, ar);
+            if (p > bestPrior) {
+                bestPrior = p;
+                m.arrow = int8_t(ar);
+            }
+        }
+    }
+    return m;
+}
+
+Move MctsEngine::search(const Position& start, int player, int timeMs, uint64_t maxPlayouts, int threads,
+                        const std::atomic<bool>* cancel, const std::atomic<bool>* ponder) {
+    Position root = start;
+    root.setSideToMove(player);
+
+    startMs = nowMs();
+    timeLimitMs = timeMs;
+    playoutLimit = maxPlayouts;
+    cancelFlag = cancel;
+    ponderFlag = ponder;
+    stopFlag.store(cancel && cancel->load());
+    playouts.store(0);
+    stats = MctsStats();
+
+    // 重置竞技场：0 号为根节点，并立即展开，保证任何时候都能给出走法
+    used.store(1);
+    Node& rootNode = nodes[0];
+    rootNode.visits.store(0);
+    rootNode.value.store(0);
+    rootNode.state.store(0);
+    rootNode.childCount = 0;
+    rootNode.player = uint8_t(player ^ 1);
+    rootNode.arrowLevel = false;
+    if (!root.canMove(player) || !expand(0, root, -1)) return Move::none();
+    rootNode.state.store(2, std::memory_order_release);
+
+    if (threads < 1) threads = 1;
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; ++i) helpers.emplace_back([this, i, &root]() { worker(i, root); });
+    worker(0, root);
+    stopFlag.store(true);
+    for (auto& t : helpers) t.join();
+
+    stats.playouts = rootNode.visits.load();
+    uint32_t allocated = used.load();
+    stats.treeNodes = allocated < capacity ? allocated : capacity;
+    stats.elapsedMs = int(nowMs() - startMs);
+    return bestMove(root);
+}
@@ -0,0 +1,55 @@
+#include "MoveOrdering.h"
+#include <cstdlib>
+#include <cstring>
+
+void MoveOrdering::clear() {
+    std::memset(queen, 0, sizeof(queen));
+    std::memset(arrows, 0, sizeof(arrows));
+    for (auto& ply : killerMoves)
+        for (Move& m : ply) m = Move::none();
+}
+
+void MoveOrdering::newSearch() {
+    for (auto& side : queen)
+        for (auto& from : side)
+            for (int16_t& h : from) h /= 2;
+    for (auto& side : arrows)
+        for (int16_t& h : side) h /= 2;
+    for (auto& ply : killerMoves)
+        for (Move& m : ply) m = Move::none();
+}
+
+int MoveOrdering::queenScore(const Position& pos, int from, int to) const {
+    return BASE_SCALE * DefaultMoveScorer::instance().queenScore(pos, from, to) + queen[pos.sideToMove][from][to];
+}
+
+int MoveOrdering::arrowScore(const Position& pos, int from, int to, int arrow) const {
+    return BASE_SCALE * DefaultMoveScorer::instance().arrowScore(pos, from, to, arrow) + arrows[pos.sideToMove][arrow];
+}
+
+// 奖励/惩罚的同时按当前值衰减，历史分自然收敛在 [-HISTORY_MAX, HISTORY_MAX] 内
+void MoveOrdering::gravity(int16_t& entry, int bonus) {
+    entry = int16_t(entry + bonus - entry * std::abs(bonus) / HISTORY_MAX);
+}
+
+void MoveOrdering::onCutoff(int side, int ply, int depth, const Move& best, const Move* tried, int triedCount) {
+    int bonus = depth * depth * 32;
+    if (bonus > HISTORY_MAX / 4) bonus = HISTORY_MAX / 4;
+
+    gravity(queen[side][best.from][best.to], bonus);
+    gravity(arrows[side][best.arrow], bonus);
+    for (int i = 0; i < triedCount; ++i) {
+        const Move& m = tried[i];
+        // 同一走子的其它射箭不惩罚走子本身
+        if (m.from != best.from || m.to != best.to) gravity(queen[side][m.from][m.to], -bonus);
+        if (m.arrow != best.arrow) gravity(arrows[side][m.arrow], -bonus);
+    }
+
+    if (ply < MAX_PLY) {
+        Move* k = killerMoves[ply];
+        if (!(k[0] == best)) {
+            for (int i = MovePicker::MAX_KILLERS - 1; i > 0; --i) k[i] = k[i - 1];
+            k[0] = best;
+        }
+    }
+}
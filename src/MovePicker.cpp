@@ -0,0 +1,126 @@
+#include "MovePicker.h"
+#include "Evaluation.h"
+#include <utility>
+
+using namespace Bitboards;
+
+int DefaultMoveScorer::queenScore(const Position&, int, int to) const {
+    return Evaluation::centerWeight(to);
+}
+
+int DefaultMoveScorer::arrowScore(const Position& pos, int, int, int arrow) const {
+    return (kingSpread(pos.amazons[pos.sideToMove ^ 1]) & squareBB(arrow)) ? 8 : 0;
+}
+
+const DefaultMoveScorer& DefaultMoveScorer::instance() {
+    static const DefaultMoveScorer scorer;
+    return scorer;
+}
+
+MovePicker::MovePicker(const Position& p, const Move& tt, const MoveScorer& s, const Move* k)
+    : pos(p), scorer(s), ttMove(tt), stage(Stage::TTMove) {
+    // 置换表走法可能来自哈希冲突，杀手走法来自同层的其它局面，都必须先校验
+    if (ttMove.isNull() || !pos.isLegal(ttMove)) {
+        ttMove = Move::none();
+        stage = Stage::Killers;
+    }
+    for (int i = 0; i < MAX_KILLERS; ++i) {
+        killers[i] = k ? k[i] : Move::none();
+        if (killers[i].isNull() || killers[i] == ttMove || !pos.isLegal(killers[i]))
+            killers[i] = Move::none();
+    }
+}
+
+bool MovePicker::alreadyTried(const Move& m) const {
+    if (m == ttMove) return true;
+    for (const Move& k : killers)
+        if (m == k) return true;
+    return false;
+}
+
+const MovePicker::Candidate& MovePicker::pickBest(Candidate* list, int index, int count) {
+    Candidate* best = list + index;
+    int bestScore = best->score;
+    for (Candidate* c = best + 1; c != list + count; ++c) {
+        if (c->score > bestScore) {
+            best = c;
+            bestScore = c->score;
+        }
+    }
+    if (best != list + index) std::swap(list[index], *best);
+    return list[index];
+}
+
+void MovePicker::generateQueens() {
+    int us = pos.sideToMove;
+    Bitboard mine = pos.amazons[us];
+    while (mine) {
+        int f = popLsb(mine);
+        Bitboard targets = pos.reachable(f);
+        while (targets && queenCount < MAX_QUEEN_MOVES) {
+            int t = popLsb(targets);
+            queens[queenCount++] = {int8_t(f), int8_t(t), scorer.queenScore(pos, f, t)};
+        }
+    }
+}
+
+void MovePicker::generateArrows(int f, int t) {
+    // 射箭时出发格已经空出
+    Bitboard occ = pos.occupied() ^ squareBB(f) ^ squareBB(t);
+    Bitboard targets = queenAttacks(t, occ);
+    arrowCount = 0;
+    arrowIndex = 0;
+    while (targets && arrowCount < MAX_ARROWS) {
+        int ar = popLsb(targets);
+        arrows[arrowCount++] = {int8_t(f), int8_t(ar), scorer.arrowScore(pos, f, t, ar)};
+    }
+    generated += arrowCount;
+}
+
+Move MovePicker::next() {
+    for (;;) {
+        switch (stage) {
+        case Stage::TTMove:
+            stage = Stage::Killers;
+            return ttMove;
+
+        case Stage::Killers:
+            while (killerIndex < MAX_KILLERS) {
+                const Move& k = killers[killerIndex++];
+                if (!k.isNull()) return k;
+            }
+            stage = Stage::GenerateQueens;
+            break;
+
+        case Stage::GenerateQueens:
+            generateQueens();
+            stage = Stage::NextQueen;
+            break;
+
+        case Stage::NextQueen:
+            if (queenIndex == queenCount) {
+                stage = Stage::Done;
+                break;
+            }
+            {
+                const Candidate& q = pickBest(queens, queenIndex++, queenCount);
+                from = q.from;
+                to = q.to;
+            }
+            generateArrows(from, to);
+            stage = Stage::NextArrow;
+            break;
+
+        case Stage::NextArrow:
+            while (arrowIndex < arrowCount) {
+                Move m = {int8_t(from), int8_t(to), pickBest(arrows, arrowIndex++, arrowCount).to};
+                if (!alreadyTried(m)) return m;
+            }
+            stage = Stage::NextQueen;
+            break;
+
+        case Stage::Done:
+            return Move::none();
+        }
+    }
+}
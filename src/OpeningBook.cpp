@@ -0,0 +1,187 @@
+#include "OpeningBook.h"
+#include "Symmetry.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "OpeningBook assumes a little-endian host"
+#endif
+
+namespace OpeningBook {
+
+namespace {
+
+// 每个局面最多收录的走法数 (按权重保留前若干个)，也是查询时栈上缓冲区的大小
+const int MAX_MOVES_PER_POSITION = 64;
+
+uint32_t packMove(const Move& m) {
+    return uint32_t(m.from) | (uint32_t(m.to) << 6) | (uint32_t(m.arrow) << 12);
+}
+
+Move unpackMove(uint32_t p) {
+    return {int8_t(p & 0x3F), int8_t((p >> 6) & 0x3F), int8_t((p >> 12) & 0x3F)};
+}
+
+} // namespace
+
+bool isBook(const uint8_t* data, size_t size) {
+    return data && size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// ==================== View ====================
+
+bool View::open(const uint8_t* data, size_t size) {
+    hdr = nullptr;
+    if (!isBook(data, size) || size < sizeof(Header)) return false;
+    const Header* h = reinterpret_cast<const Header*>(data);
+    if (h->version != VERSION || h->headerSize != sizeof(Header)) return false;
+
+    // 只校验各段边界；条目中的走法下标在查询时检查，打开文件不随书的大小变慢
+    uint64_t movesOffset = sizeof(Header) + uint64_t(h->positionCount) * sizeof(PositionEntry);
+    uint64_t end = movesOffset + uint64_t(h->moveCount) * sizeof(MoveEntry);
+    if (end > size) return false;
+
+    hdr = h;
+    positions = reinterpret_cast<const PositionEntry*>(data + sizeof(Header));
+    moveTable = reinterpret_cast<const MoveEntry*>(data + movesOffset);
+    return true;
+}
+
+const PositionEntry* View::find(uint64_t key) const {
+    if (!hdr) return nullptr;
+    const PositionEntry* end = positions + hdr->positionCount;
+    const PositionEntry* it = std::lower_bound(positions, end, key,
+        [](const PositionEntry& e, uint64_t k) { return e.key < k; });
+    if (it == end || it->key != key) return nullptr;
+    if (uint64_t(it->firstMove) + it->moveCount > hdr->moveCount) return nullptr;
+    return it;
+}
+
+int View::moves(const Position& pos, BookMove* out, int maxMoves) const {
+    const Symmetry::Key key = Symmetry::canonicalKey(pos);
+    const PositionEntry* e = find(key.hash);
+    if (!e) return 0;
+    int n = 0;
+    for (uint32_t i = 0; i < e->moveCount && n < maxMoves; ++i) {
+        const MoveEntry& me = moveTable[e->firstMove + i];
+        Move m = key.fromCanonical({int8_t(me.from), int8_t(me.to), int8_t(me.arrow)});
+        // 哈希碰撞或文件损坏时走法可能不合法，直接跳过
+        if (me.weight == 0 || !pos.isLegal(m)) continue;
+        out[n++] = {m, me.weight};
+    }
+    return n;
+}
+
+Move View::pick(const Position& pos, uint64_t random) const {
+    BookMove list[MAX_MOVES_PER_POSITION];
+    int n = moves(pos, list, MAX_MOVES_PER_POSITION);
+    if (n == 0) return Move::none();
+    uint64_t total = 0;
+    for (int i = 0; i < n; ++i) total += list[i].weight;
+    uint64_t r = random % total;
+    for (int i = 0; i < n; ++i) {
+        if (r < list[i].weight) return list[i].move;
+        r -= list[i].weight;
+    }
+    return list[n - 1].move;
+}
+
+Move View::best(const Position& pos) const {
+    BookMove list[MAX_MOVES_PER_POSITION];
+    int n = moves(pos, list, MAX_MOVES_PER_POSITION);
+    if (n == 0) return Move::none();
+    const BookMove* top = std::max_element(list, list + n,
+        [](const BookMove& a, const BookMove& b) { return a.weight < b.weight; });
+    return top->move;
+}
+
+// ==================== Book ====================
+
+bool Book::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    if (!view.open(file.data(), file.size())) {
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+void Book::close() {
+    view = View();
+    file.close();
+}
+
+// ==================== Builder ====================
+
+void Builder::add(const Position& pos, const Move& move, uint32_t weight) {
+    if (move.isNull() || weight == 0) return;
+    const Symmetry::Key key = Symmetry::canonicalKey(pos);
+    table[key.hash][packMove(key.toCanonical(move))] += weight;
+}
+
+std::vector<uint8_t> Builder::encode(uint32_t minWeight, uint32_t maxPly) const {
+    std::vector<PositionEntry> positionEntries;
+    std::vector<MoveEntry> moveEntries;
+    std::vector<std::pair<uint64_t, uint32_t>> kept;
+    // std::map 按 key 升序遍历，正好满足二分查找的要求
+    for (const auto& pos : table) {
+        kept.clear();
+        for (const auto& mv : pos.second)
+            if (mv.second >= minWeight) kept.push_back({mv.second, mv.first});
+        if (kept.empty()) continue;
+        // 权重从大到小，同权重按走法排序，保证输出确定
+        std::sort(kept.begin(), kept.end(), [](const std::pair<uint64_t, uint32_t>& a,
+                                               const std::pair<uint64_t, uint32_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        if (kept.size() > size_t(MAX_MOVES_PER_POSITION)) kept.resize(MAX_MOVES_PER_POSITION);
+
+        PositionEntry pe;
+        pe.key = pos.first;
+        pe.firstMove = uint32_t(moveEntries.size());
+        pe.moveCount = uint16_t(kept.size());
+        pe.reserved = 0;
+        positionEntries.push_back(pe);
+        for (const auto& k : kept) {
+            Move m = unpackMove(k.second);
+            MoveEntry me;
+            me.from = uint8_t(m.from);
+            me.to = uint8_t(m.to);
+            me.arrow = uint8_t(m.arrow);
+            me.reserved = 0;
+            me.weight = uint32_t(std::min<uint64_t>(k.first, UINT32_MAX));
+            moveEntries.push_back(me);
+        }
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.headerSize = sizeof(Header);
+    h.positionCount = uint32_t(positionEntries.size());
+    h.moveCount = uint32_t(moveEntries.size());
+    h.maxPly = maxPly;
+
+    std::vector<uint8_t> buf(sizeof(Header) + positionEntries.size() * sizeof(PositionEntry)
+                             + moveEntries.size() * sizeof(MoveEntry));
+    uint8_t* p = buf.data();
+    std::memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+    if (!positionEntries.empty()) std::memcpy(p, positionEntries.data(), positionEntries.size() * sizeof(PositionEntry));
+    p += positionEntries.size() * sizeof(PositionEntry);
+    if (!moveEntries.empty()) std::memcpy(p, moveEntries.data(), moveEntries.size() * sizeof(MoveEntry));
+    return buf;
+}
+
+bool Builder::write(const std::string& path, uint32_t minWeight, uint32_t maxPly) const {
+    std::vector<uint8_t> buf = encode(minWeight, maxPly);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(buf.data()), std::streamsize(buf.size()));
+    return bool(out);
+}
+
+} // namespace OpeningBook
@@ -0,0 +1,165 @@
+#include "Perft.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace Bitboards;
+
+namespace Perft {
+
+namespace {
+
+// (局面, 剩余深度) → 计数 的无锁缓存，与 TranspositionTable 一样用 key ^ data 校验撕裂写入
+class CountCache {
+public:
+    explicit CountCache(size_t megabytes) {
+        size_t want = megabytes * 1024 * 1024 / sizeof(Slot);
+        size_t n = 1;
+        while (n * 2 <= want) n *= 2;
+        slots.reset(new Slot[n]);
+        mask = n - 1;
+        for (size_t i = 0; i < n; ++i) {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // data：低 6 位为深度，其余为计数
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const {
+        const Slot& s = slots[key & mask];
+        uint64_t data = s.data.load(std::memory_order_relaxed);
+        if ((s.check.load(std::memory_order_relaxed) ^ data) != key || int(data & 63) != depth) return false;
+        nodes = data >> 6;
+        return true;
+    }
+
+    void store(uint64_t key, int depth, uint64_t nodes) {
+        Slot& s = slots[key & mask];
+        uint64_t data = (nodes << 6) | uint64_t(depth);
+        s.check.store(key ^ data, std::memory_order_relaxed);
+        s.data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+    std::unique_ptr<Slot[]> slots;
+    uint64_t mask = 0;
+};
+
+uint64_t countMoves(const Position& pos) {
+    uint64_t n = 0;
+    Position sim = pos;
+    int us = pos.sideToMove;
+    Bitboard pieces = pos.amazons[us];
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard targets = pos.reachable(from);
+        while (targets) {
+            int to = popLsb(targets);
+            sim.moveAmazon(us, from, to);
+            n += popCount(sim.reachable(to));
+            sim.moveAmazon(us, to, from);
+        }
+    }
+    return n;
+}
+
+template <typename F>
+void forEachMove(Position& pos, F&& f) {
+    int us = pos.sideToMove;
+    Bitboard pieces = pos.amazons[us];
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard targets = pos.reachable(from);
+        while (targets) {
+            int to = popLsb(targets);
+            pos.moveAmazon(us, from, to);
+            Bitboard arrows = pos.reachable(to);
+            pos.moveAmazon(us, to, from);
+            while (arrows) f(Move{int8_t(from), int8_t(to), int8_t(popLsb(arrows))});
+        }
+    }
+}
+
+uint64_t perft(Position& pos, int depth, CountCache* cache) {
+    if (depth == 1) return countMoves(pos);
+    uint64_t nodes = 0;
+    if (cache && cache->probe(pos.hash, depth, nodes)) return nodes;
+    forEachMove(pos, [&](const Move& m) {
+        pos.makeMove(m);
+        nodes += perft(pos, depth - 1, cache);
+        pos.unmakeMove(m);
+    });
+    if (cache) cache->store(pos.hash, depth, nodes);
+    return nodes;
+}
+
+std::vector<Move> rootMoves(const Position& start) {
+    std::vector<Move> moves;
+    Position pos = start;
+    forEachMove(pos, [&](const Move& m) { moves.push_back(m); });
+    return moves;
+}
+
+} // namespace
+
+uint64_t count(const Position& start, int depth) {
+    if (depth <= 0) return 1;
+    Position pos = start;
+    return perft(pos, depth, nullptr);
+}
+
+Result run(const Position& start, int depth, const Options& options) {
+    auto t0 = std::chrono::steady_clock::now();
+    Result result;
+    std::unique_ptr<CountCache> cache;
+    if (options.hashMB > 0 && depth >= 3) cache.reset(new CountCache(options.hashMB));
+
+    if (depth <= 1 || options.threads <= 1) {
+        Position pos = start;
+        result.nodes = depth <= 0 ? 1 : perft(pos, depth, cache.get());
+    } else {
+        // 根节点走法按下标分给各线程 (原子计数器领取)，结果最后相加
+        const std::vector<Move> moves = rootMoves(start);
+        std::atomic<size_t> next{0};
+        std::atomic<uint64_t> total{0};
+        auto worker = [&]() {
+            Position pos = start;
+            uint64_t local = 0;
+            for (size_t i; (i = next.fetch_add(1)) < moves.size();) {
+                pos.makeMove(moves[i]);
+                local += perft(pos, depth - 1, cache.get());
+                pos.unmakeMove(moves[i]);
+            }
+            total.fetch_add(local);
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < options.threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+        result.nodes = total.load();
+    }
+
+    result.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+std::vector<std::pair<Move, uint64_t>> divide(const Position& start, int depth) {
+    std::vector<std::pair<Move, uint64_t>> out;
+    if (depth <= 0) return out;
+    Position pos = start;
+    for (const Move& m : rootMoves(start)) {
+        pos.makeMove(m);
+        out.push_back({m, depth == 1 ? 1 : perft(pos, depth - 1, nullptr)});
+        pos.unmakeMove(m);
+    }
+    return out;
+}
+
+} // namespace Perft
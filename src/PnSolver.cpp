@@ -0,0 +1,235 @@
+#include "PnSolver.h"
+#include "MoveList.h"
+#include "Regions.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace Bitboards;
+
+namespace {
+
+// 一个节点最多的子节点数 (与定长走法列表相同)
+const int MAX_CHILDREN = MoveList::CAPACITY;
+
+// 1+ε 技巧：次优子节点的 delta 放大 1/4 作为当前子节点的阈值
+const uint32_t EPSILON_DIV = 4;
+
+uint32_t saturatingAdd(uint32_t a, uint32_t b, uint32_t limit) {
+    uint64_t s = uint64_t(a) + b;
+    return s >= limit ? limit : uint32_t(s);
+}
+
+} // namespace
+
+PnSolver::PnSolver(size_t megabytes)
+    : childStack(new Child[size_t(MAX_PLY) * MAX_CHILDREN]) {
+    resize(megabytes);
+}
+
+void PnSolver::resize(size_t megabytes) {
+    if (megabytes == 0) megabytes = 1;
+    size_t want = megabytes * 1024 * 1024 / sizeof(Bucket);
+    size_t count = 1;
+    while (count * 2 <= want) count *= 2;
+
+    buckets.reset(new Bucket[count]);
+    bucketCount = count;
+    bucketMask = count - 1;
+    clear();
+}
+
+void PnSolver::clear() {
+    for (size_t i = 0; i < bucketCount; ++i)
+        for (auto& e : buckets[i].entries) e = Entry();
+    generation = 0;
+}
+
+bool PnSolver::applicable(const Position& pos) {
+    Bitboard empty = pos.empty();
+    Bitboard reach = Regions::flood(kingSpread(pos.amazons[0] | pos.amazons[1]) & empty, empty);
+    return popCount(reach) <= MAX_SQUARES;
+}
+
+const PnSolver::Entry* PnSolver::find(uint64_t key) const {
+    const Bucket& b = buckets[key & bucketMask];
+    for (const Entry& e : b.entries)
+        if (e.key == key && !e.best.isNull()) return &e;
+    return nullptr;
+}
+
+void PnSolver::store(uint64_t key, const Numbers& n, uint64_t work) {
+    Bucket& b = buckets[key & bucketMask];
+    // 同一局面直接覆盖；否则替换 "价值" 最低的条目：旧代且未证明的条目价值为 0，
+    // 其余按花费的节点数，已证明的结论因此跨回合保留
+    Entry* victim = nullptr;
+    uint64_t victimValue = UINT64_MAX;
+    for (Entry& e : b.entries) {
+        if (e.key == key) {
+            victim = &e;
+            break;
+        }
+        bool proven = e.phi == 0 || e.delta == 0;
+        uint64_t value = e.best.isNull() ? 0 : (e.generation != generation && !proven) ? 1 : 2 + uint64_t(e.work);
+        if (value < victimValue) {
+            victim = &e;
+            victimValue = value;
+        }
+    }
+    victim->key = key;
+    victim->phi = n.phi;
+    victim->delta = n.delta;
+    victim->work = uint32_t(std::min<uint64_t>(work, UINT32_MAX));
+    victim->best = n.best;
+    victim->generation = generation;
+}
+
+// 未展开节点的初值：终局直接给出结论，其余为 (1, 1)
+PnSolver::Numbers PnSolver::evaluate(const Position& pos) const {
+    int us = pos.sideToMove;
+    if (!pos.canMove(us)) return {INF, 0, Move::none()};
+    Regions::Outcome outcome = Regions::decide(pos, tablebase);
+    if (outcome.decided) return outcome.winner == us ? Numbers{0, INF, Move::none()} : Numbers{INF, 0, Move::none()};
+    return {1, 1, Move::none()};
+}
+
+bool PnSolver::shouldStop() {
+    if (aborted) return true;
+    if (nodeLimit && nodes >= nodeLimit) aborted = true;
+    if ((nodes & 1023) == 0 && stopFlag && stopFlag->load(std::memory_order_relaxed)) aborted = true;
+    return aborted;
+}
+
+// 多重迭代加深 (MID)：展开 pos 直到其 phi >= thPhi 或 delta >= thDelta
+PnSolver::Numbers PnSolver::mid(Position& pos, uint32_t thPhi, uint32_t thDelta, int ply) {
+    ++nodes;
+    const uint64_t startNodes = nodes;
+    const int us = pos.sideToMove;
+    Child* children = childStack.get() + size_t(ply) * MAX_CHILDREN;
+    int count = 0;
+
+    // 生成全部子节点并取初值：置换表中已有的直接沿用；一旦有子节点对方必败，本节点即必胜
+    Bitboard pieces = pos.amazons[us];
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard targets = pos.reachable(from);
+        while (targets) {
+            int to = popLsb(targets);
+            pos.moveAmazon(us, from, to);
+            Bitboard arrows = pos.reachable(to);
+            pos.moveAmazon(us, to, from);
+            while (arrows && count < MAX_CHILDREN) {
+                Move m = {int8_t(from), int8_t(to), int8_t(popLsb(arrows))};
+                pos.makeMove(m);
+                const Entry* e = find(pos.hash);
+                Numbers n = e ? Numbers{e->phi, e->delta, e->best} : evaluate(pos);
+                pos.unmakeMove(m);
+                if (n.delta == 0) {
+                    Numbers won = {0, INF, m};
+                    store(pos.hash, won, 1);
+                    return won;
+                }
+                children[count++] = {m, n.phi, n.delta};
+            }
+        }
+    }
+
+    for (;;) {
+        // phi = min delta(子)，delta = Σ phi(子)；同时记下次优的 delta 用于 1+ε 阈值
+        uint32_t phi = INF, second = INF, delta = 0;
+        int bestIndex = 0;
+        for (int i = 0; i < count; ++i) {
+            const Child& c = children[i];
+            if (c.delta < phi) {
+                second = phi;
+                phi = c.delta;
+                bestIndex = i;
+            } else if (c.delta < second) {
+                second = c.delta;
+            }
+            delta = saturatingAdd(delta, c.phi, INF);
+        }
+        if (phi == 0) delta = INF;
+
+        Child& best = children[bestIndex];
+        Numbers current = {phi, delta, best.move};
+        if (phi >= thPhi || delta >= thDelta || ply + 1 >= MAX_PLY || shouldStop()) {
+            store(pos.hash, current, nodes - startNodes + 1);
+            return current;
+        }
+
+        // 子节点的 delta 决定本节点的 phi：超过次优者 (放大 1+ε) 就该换到另一个子节点；
+        // 子节点的 phi 计入本节点的 delta：本节点剩余的余量全部给它
+        uint32_t widened = second >= INF ? INF : std::max(second + 1, saturatingAdd(second, second / EPSILON_DIV, INF));
+        uint32_t childThDelta = std::min(thPhi, widened);
+        uint32_t childThPhi = thDelta - delta + best.phi;
+
+        pos.makeMove(best.move);
+        Numbers r = mid(pos, childThPhi, childThDelta, ply + 1);
+        pos.unmakeMove(best.move);
+        best.phi = r.phi;
+        best.delta = r.delta;
+    }
+}
+
+SolveResult PnSolver::solve(const Position& start, const std::atomic<bool>* stop, uint64_t maxNodes,
+                            const Tablebase::View* tb) {
+    auto t0 = std::chrono::steady_clock::now();
+    SolveResult result;
+    Position pos = start;
+
+    Numbers root = evaluate(pos);
+    if (root.phi == 0 || root.delta == 0) {
+        // 终局或区域已定胜负：无需展开 (必胜时走法交给调用方的常规搜索)
+        result.status = root.phi == 0 ? SolveStatus::Win : SolveStatus::Loss;
+        return result;
+    }
+
+    stopFlag = stop;
+    tablebase = tb;
+    nodeLimit = maxNodes;
+    nodes = 0;
+    aborted = false;
+    generation = uint8_t(generation + 1);
+
+    result = lookup(pos);
+    if (result.status == SolveStatus::Unknown) {
+        Numbers n = mid(pos, INF, INF, 0);
+        if (n.phi == 0) {
+            result.status = SolveStatus::Win;
+            result.best = n.best;
+        } else if (n.delta == 0) {
+            result.status = SolveStatus::Loss;
+        }
+    }
+    result.nodes = nodes;
+    result.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    stopFlag = nullptr;
+    tablebase = nullptr;
+    return result;
+}
+
+SolveResult PnSolver::lookup(const Position& pos) const {
+    SolveResult result;
+    const Entry* e = find(pos.hash);
+    if (!e) return result;
+    if (e->phi == 0 && pos.isLegal(e->best)) {
+        result.status = SolveStatus::Win;
+        result.best = e->best;
+    } else if (e->delta == 0) {
+        result.status = SolveStatus::Loss;
+    }
+    return result;
+}
+
+int PnSolver::provenLine(const Position& start, Move* out, int maxMoves) const {
+    Position pos = start;
+    int n = 0;
+    while (n < maxMoves) {
+        const Entry* e = find(pos.hash);
+        if (!e || (e->phi != 0 && e->delta != 0) || !pos.isLegal(e->best)) break;
+        out[n++] = e->best;
+        pos.makeMove(e->best);
+    }
+    return n;
+}
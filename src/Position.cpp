@@ -0,0 +1,92 @@
+#include "Position.h"
+
+using namespace Bitboards;
+
+Position Position::startPosition() {
+    Position pos;
+    // 红方棋子 (1) - 8x8 适配
+    pos.amazons[1] = squareBB(squareOf(2, 0)) | squareBB(squareOf(5, 0))
+                   | squareBB(squareOf(0, 2)) | squareBB(squareOf(7, 2));
+    // 蓝方棋子 (0) - 8x8 适配
+    pos.amazons[0] = squareBB(squareOf(2, 7)) | squareBB(squareOf(5, 7))
+                   | squareBB(squareOf(0, 5)) | squareBB(squareOf(7, 5));
+    pos.arrows = 0;
+    pos.sideToMove = 1; // 红方先手
+    pos.refreshHash();
+    return pos;
+}
+
+bool Position::isLegal(const Move& m) const {
+    if (m.from < 0 || m.from >= 64 || m.to < 0 || m.to >= 64 || m.arrow < 0 || m.arrow >= 64) return false;
+    if (!(amazons[sideToMove] & squareBB(m.from))) return false;
+    if (!(reachable(m.from) & squareBB(m.to))) return false;
+    // 射箭时出发格已经空出
+    Bitboard occ = occupied() ^ squareBB(m.from) ^ squareBB(m.to);
+    return (queenAttacks(m.to, occ) & squareBB(m.arrow)) != 0;
+}
+
+uint64_t Position::computeHash() const {
+    uint64_t h = 0;
+    for (int c = 0; c < 2; ++c) {
+        Bitboard b = amazons[c];
+        while (b) h ^= Zobrist::amazon(c, popLsb(b));
+    }
+    Bitboard b = arrows;
+    while (b) h ^= Zobrist::arrow(popLsb(b));
+    if (sideToMove == 0) h ^= Zobrist::side();
+    return h;
+}
+
+std::string Position::toString() const {
+    std::string s;
+    for (int row = 7; row >= 0; --row) {
+        int run = 0;
+        for (int col = 0; col < 8; ++col) {
+            int sq = squareOf(col, row);
+            char c = (amazons[1] >> sq) & 1 ? 'R' : (amazons[0] >> sq) & 1 ? 'B' : (arrows >> sq) & 1 ? 'x' : 0;
+            if (!c) {
+                ++run;
+                continue;
+            }
+            if (run) s += char('0' + run);
+            run = 0;
+            s += c;
+        }
+        if (run) s += char('0' + run);
+        if (row) s += '/';
+    }
+    s += sideToMove == 1 ? " r" : " b";
+    return s;
+}
+
+bool Position::fromString(const std::string& text, Position& out) {
+    Position pos;
+    int row = 7, col = 0;
+    size_t i = 0;
+    for (; i < text.size() && text[i] != ' '; ++i) {
+        char c = text[i];
+        if (c == '/') {
+            if (col != 8 || row == 0) return false;
+            --row;
+            col = 0;
+        } else if (c >= '1' && c <= '8') {
+            col += c - '0';
+            if (col > 8) return false;
+        } else {
+            if (col >= 8) return false;
+            Bitboard b = squareBB(squareOf(col, row));
+            if (c == 'R') pos.amazons[1] |= b;
+            else if (c == 'B') pos.amazons[0] |= b;
+            else if (c == 'x') pos.arrows |= b;
+            else return false;
+            ++col;
+        }
+    }
+    if (row != 0 || col != 8 || i + 2 != text.size()) return false;
+    if (text[i + 1] == 'r') pos.sideToMove = 1;
+    else if (text[i + 1] == 'b') pos.sideToMove = 0;
+    else return false;
+    pos.refreshHash();
+    out = pos;
+    return true;
+}
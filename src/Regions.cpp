@@ -0,0 +1,164 @@
+#include "Regions.h"
+
+using namespace Bitboards;
+
+namespace Regions {
+
+Bitboard flood(Bitboard seeds, Bitboard within) {
+    Bitboard filled = seeds & within;
+    for (;;) {
+        Bitboard next = (filled | kingSpread(filled)) & within;
+        if (next == filled) return filled;
+        filled = next;
+    }
+}
+
+bool separated(const Position& pos) {
+    Bitboard empty = pos.empty();
+    Bitboard reach0 = flood(kingSpread(pos.amazons[0]) & empty, empty);
+    return (reach0 & kingSpread(pos.amazons[1])) == 0;
+}
+
+int moveLowerBound(const Position& pos, int player) {
+    Bitboard free = pos.empty();
+    int moves = 0;
+    Bitboard pieces = pos.amazons[player];
+    while (pieces) {
+        int cur = popLsb(pieces);
+        // 每步走到一个相邻空格并把箭射回出发格；优先走出口最少的格子 (Warnsdorff)，
+        // 以免过早把路径切断
+        for (;;) {
+            Bitboard next = kingAttacks(cur) & free;
+            if (!next) break;
+            int best = -1, bestExits = 9;
+            while (next) {
+                int sq = popLsb(next);
+                int exits = popCount(kingAttacks(sq) & free);
+                if (exits < bestExits) {
+                    best = sq;
+                    bestExits = exits;
+                }
+            }
+            free &= ~squareBB(best);
+            cur = best;
+            ++moves;
+        }
+    }
+    return moves;
+}
+
+namespace {
+
+struct Bounds {
+    int lower;
+    int upper;
+};
+
+// 分隔后 player 的步数范围
+Bounds moveBounds(const Position& pos, int player, const Tablebase::View* tablebase) {
+    Bitboard empty = pos.empty();
+    if (tablebase && tablebase->isOpen()) {
+        // 每个亚马逊各自的区域互不相交时，步数是各区域查表结果之和
+        int exact = 0;
+        Bitboard seen = 0;
+        Bitboard pieces = pos.amazons[player];
+        while (pieces) {
+            int sq = popLsb(pieces);
+            Bitboard area = flood(kingAttacks(sq) & empty, empty);
+            int moves = (area & seen) ? -1 : tablebase->probe(area, sq);
+            if (moves < 0) break;
+            seen |= area;
+            exact += moves;
+            if (!pieces) return {exact, exact};
+        }
+    }
+    // 已分隔：能到达的空格恰好是独占区域
+    return {moveLowerBound(pos, player), popCount(flood(kingSpread(pos.amazons[player]) & empty, empty))};
+}
+
+} // namespace
+
+Outcome decide(const Position& pos, const Tablebase::View* tablebase) {
+    Outcome out;
+    if (!separated(pos)) return out;
+
+    int us = pos.sideToMove, them = us ^ 1;
+    Bounds b = moveBounds(pos, us, tablebase);
+    Bounds o = moveBounds(pos, them, tablebase);
+    int lowerUs = b.lower, upperUs = b.upper;
+    int lowerThem = o.lower, upperThem = o.upper;
+
+    if (lowerUs > upperThem) {
+        out.decided = true;
+        out.winner = us;
+        out.margin = lowerUs - upperThem;
+        return out;
+    }
+    if (upperUs <= lowerThem) {
+        out.decided = true;
+        out.winner = them;
+        out.margin = lowerThem - upperUs;
+    }
+    return out;
+}
+
+} // namespace Regions
+
+// ==================== RegionMap ====================
+
+void RegionMap::reset(const Position& pos) {
+    regionCount = 0;
+    floodRemaining(pos.empty(), pos);
+}
+
+void RegionMap::update(const Position& pos, Bitboard changed) {
+    // 与变化格子相交或相邻的区域可能被切开、合并或改变归属，全部拆掉重新泛洪
+    Bitboard affected = changed | kingSpread(changed);
+    Bitboard redo = changed & pos.empty();
+    int kept = 0;
+    for (int i = 0; i < regionCount; ++i) {
+        if (regions[i].squares & affected) redo |= regions[i].squares;
+        else regions[kept++] = regions[i];
+    }
+    regionCount = kept;
+    floodRemaining(redo & pos.empty(), pos);
+}
+
+void RegionMap::floodRemaining(Bitboard squares, const Position& pos) {
+    Bitboard empty = pos.empty();
+    while (squares && regionCount < Regions::MAX_REGIONS) {
+        Regions::Region& r = regions[regionCount++];
+        r.squares = Regions::flood(squares & (0 - squares), empty);
+        classify(r, pos);
+        squares &= ~r.squares;
+    }
+}
+
+void RegionMap::classify(Regions::Region& r, const Position& pos) const {
+    Bitboard around = kingSpread(r.squares);
+    bool touches0 = (around & pos.amazons[0]) != 0;
+    bool touches1 = (around & pos.amazons[1]) != 0;
+    if (touches0 && touches1) {
+        r.kind = Regions::Kind::Contested;
+        r.owner = -1;
+    } else if (touches0 || touches1) {
+        r.kind = Regions::Kind::Owned;
+        r.owner = touches1 ? 1 : 0;
+    } else {
+        r.kind = Regions::Kind::Dead;
+        r.owner = -1;
+    }
+}
+
+bool RegionMap::separated() const {
+    for (int i = 0; i < regionCount; ++i)
+        if (regions[i].kind == Regions::Kind::Contested) return false;
+    return true;
+}
+
+int RegionMap::ownedArea(int player) const {
+    int area = 0;
+    for (int i = 0; i < regionCount; ++i)
+        if (regions[i].kind == Regions::Kind::Owned && regions[i].owner == player) area += regions[i].area();
+    return area;
+}
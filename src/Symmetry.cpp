@@ -0,0 +1,50 @@
+#include "Symmetry.h"
+
+namespace Symmetry {
+
+Position canonicalize(const Position& pos, int* transform) {
+    const int us = pos.sideToMove;
+    const Bitboard mine = pos.amazons[us], theirs = pos.amazons[us ^ 1];
+
+    int best = 0;
+    Bitboard bestArrows = pos.arrows, bestMine = mine, bestTheirs = theirs;
+    for (int t = 1; t < COUNT; ++t) {
+        Bitboard a = apply(pos.arrows, t);
+        if (a > bestArrows) continue;
+        Bitboard m = apply(mine, t);
+        if (a == bestArrows && m > bestMine) continue;
+        Bitboard o = apply(theirs, t);
+        if (a == bestArrows && m == bestMine && o >= bestTheirs) continue;
+        best = t;
+        bestArrows = a;
+        bestMine = m;
+        bestTheirs = o;
+    }
+
+    Position out;
+    out.amazons[1] = bestMine;
+    out.amazons[0] = bestTheirs;
+    out.arrows = bestArrows;
+    out.sideToMove = 1;
+    out.refreshHash();
+    if (transform) *transform = best;
+    return out;
+}
+
+Key canonicalKey(const Position& pos) {
+    Key key;
+    key.hash = canonicalize(pos, &key.transform).hash;
+    return key;
+}
+
+Position apply(const Position& pos, int t) {
+    Position out;
+    out.amazons[0] = apply(pos.amazons[0], t);
+    out.amazons[1] = apply(pos.amazons[1], t);
+    out.arrows = apply(pos.arrows, t);
+    out.sideToMove = pos.sideToMove;
+    out.refreshHash();
+    return out;
+}
+
+} // namespace Symmetry
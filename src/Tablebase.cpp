@@ -0,0 +1,125 @@
+#include "Tablebase.h"
+#include "Symmetry.h"
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Tablebase assumes a little-endian host"
+#endif
+
+using namespace Bitboards;
+
+namespace Tablebase {
+
+namespace {
+
+// 平移到左下角：最低行为第 0 行，最左列为第 0 列
+Key normalize(Bitboard cells, Bitboard amazon) {
+    int shift = lsb(cells) & ~7;
+    Bitboard cols = cells >> shift;
+    cols |= cols >> 32;
+    cols |= cols >> 16;
+    cols |= cols >> 8;
+    shift += lsb(cols & 0xFF);
+    return {cells >> shift, uint8_t(lsb(amazon >> shift))};
+}
+
+uint64_t hashKey(const Key& k) {
+    uint64_t h = k.cells ^ (uint64_t(k.amazon) * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace
+
+Key canonicalKey(Bitboard area, int amazon) {
+    Bitboard cells = area | squareBB(amazon);
+    Key best = normalize(cells, squareBB(amazon));
+    for (int t = 1; t < Symmetry::COUNT; ++t) {
+        Key k = normalize(Symmetry::apply(cells, t), squareBB(Symmetry::applySquare(amazon, t)));
+        if (k < best) best = k;
+    }
+    return best;
+}
+
+std::vector<uint8_t> encode(int maxSquares, const std::vector<Entry>& entries) {
+    uint64_t slotCount = 1;
+    while (slotCount < entries.size() * 2) slotCount <<= 1;
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.headerSize = sizeof(Header);
+    h.maxSquares = uint8_t(maxSquares);
+    h.slotCount = slotCount;
+    h.entryCount = entries.size();
+
+    std::vector<uint8_t> buf(sizeof(Header) + slotCount * sizeof(Entry), 0);
+    std::memcpy(buf.data(), &h, sizeof(h));
+    Entry* slots = reinterpret_cast<Entry*>(buf.data() + sizeof(Header));
+    for (const Entry& e : entries) {
+        uint64_t i = hashKey({e.cells, e.amazon}) & (slotCount - 1);
+        while (slots[i].cells && !(slots[i].cells == e.cells && slots[i].amazon == e.amazon))
+            i = (i + 1) & (slotCount - 1);
+        slots[i] = e;
+    }
+    return buf;
+}
+
+bool isTablebase(const uint8_t* data, size_t size) {
+    return data && size >= sizeof(MAGIC) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool View::open(const uint8_t* data, size_t size) {
+    hdr = nullptr;
+    if (!isTablebase(data, size) || size < sizeof(Header)) return false;
+    const Header* h = reinterpret_cast<const Header*>(data);
+    if (h->version != VERSION || h->headerSize != sizeof(Header)) return false;
+    // 槽位数必须是 2 的幂；正常生成的文件至少留一个空槽 (probe 另有次数上限，不依赖这一点)
+    if (h->slotCount == 0 || (h->slotCount & (h->slotCount - 1)) || h->entryCount >= h->slotCount) return false;
+    if (h->slotCount > (size - sizeof(Header)) / sizeof(Entry)) return false;
+
+    hdr = h;
+    slots = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    return true;
+}
+
+int View::probe(Bitboard area, int amazon) const {
+    if (!area) return 0;
+    if (!hdr || popCount(area) > hdr->maxSquares) return -1;
+    return probe(canonicalKey(area, amazon));
+}
+
+int View::probe(const Key& key) const {
+    if (!hdr) return -1;
+    uint64_t mask = hdr->slotCount - 1;
+    // entryCount 只是头部声明的值，损坏的文件可能没有空槽：最多探测 slotCount 次
+    uint64_t i = hashKey(key) & mask;
+    for (uint64_t n = 0; n < hdr->slotCount; ++n, i = (i + 1) & mask) {
+        const Entry& e = slots[i];
+        if (!e.cells) return -1;
+        if (e.cells == key.cells && e.amazon == key.amazon) return e.moves;
+    }
+    return -1;
+}
+
+bool Table::open(const std::string& path) {
+    close();
+    if (!file.open(path)) return false;
+    if (!view.open(file.data(), file.size())) {
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+void Table::close() {
+    view = View();
+    file.close();
+}
+
+} // namespace Tablebase
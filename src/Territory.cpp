@@ -0,0 +1,351 @@
+#include "Territory.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TERRITORY_X86 1
+#include <immintrin.h>
+#endif
+
+// 只给个别函数打开对应指令集，其余代码仍按基线编译，运行时再按 CPU 选择
+#define TARGET(isa) __attribute__((target(isa)))
+#define FORCE_INLINE inline __attribute__((always_inline))
+
+using namespace Bitboards;
+
+namespace Territory {
+
+namespace {
+
+// --- 按位并行的皇后步扩展 ---
+// 一次调用同时扩展双方：gen[c] 为 c 方的出发格，返回经空格一次皇后走法可到达的空格。
+// 每个方向做一次 Kogge-Stone 遮挡填充 (3 次倍增移位)，再移一步得到攻击集合。
+typedef void (*QueenStepFn)(const Bitboard gen[2], Bitboard empty, Bitboard out[2]);
+
+struct Shift {
+    int amount;
+    Bitboard mask;  // 去掉跨越 A/H 列边界的位
+};
+
+constexpr Bitboard NotA = ~FileA;
+constexpr Bitboard NotH = ~FileH;
+constexpr Bitboard AllSquares = ~0ULL;
+
+// 左移：East, North, NorthEast, NorthWest；右移：West, South, SouthWest, SouthEast
+constexpr Shift leftShifts[4] = {{1, NotA}, {8, AllSquares}, {9, NotA}, {7, NotH}};
+constexpr Shift rightShifts[4] = {{1, NotH}, {8, AllSquares}, {9, NotH}, {7, NotA}};
+
+inline Bitboard fillLeft(Bitboard g, Bitboard p, int s, Bitboard mask) {
+    p &= mask;
+    g |= p & (g << s);
+    p &= p << s;
+    g |= p & (g << 2 * s);
+    p &= p << 2 * s;
+    g |= p & (g << 4 * s);
+    return (g << s) & mask;
+}
+
+inline Bitboard fillRight(Bitboard g, Bitboard p, int s, Bitboard mask) {
+    p &= mask;
+    g |= p & (g >> s);
+    p &= p >> s;
+    g |= p & (g >> 2 * s);
+    p &= p >> 2 * s;
+    g |= p & (g >> 4 * s);
+    return (g >> s) & mask;
+}
+
+void queenStepScalar(const Bitboard gen[2], Bitboard empty, Bitboard out[2]) {
+    for (int c = 0; c < 2; ++c) {
+        Bitboard r = 0;
+        for (int i = 0; i < 4; ++i) {
+            r |= fillLeft(gen[c], empty, leftShifts[i].amount, leftShifts[i].mask);
+            r |= fillRight(gen[c], empty, rightShifts[i].amount, rightShifts[i].mask);
+        }
+        out[c] = r & empty;
+    }
+}
+
+#ifdef TERRITORY_X86
+
+// SSE2：两条 64 位通道分别是双方，同一方向的移位量相同
+TARGET("sse2") void queenStepSse2(const Bitboard gen[2], Bitboard empty, Bitboard out[2]) {
+    const __m128i g0 = _mm_set_epi64x((long long)gen[1], (long long)gen[0]);
+    const __m128i e = _mm_set1_epi64x((long long)empty);
+    __m128i acc = _mm_setzero_si128();
+    for (int i = 0; i < 4; ++i) {
+        const __m128i s1 = _mm_cvtsi32_si128(leftShifts[i].amount);
+        const __m128i s2 = _mm_cvtsi32_si128(2 * leftShifts[i].amount);
+        const __m128i s4 = _mm_cvtsi32_si128(4 * leftShifts[i].amount);
+
+        __m128i m = _mm_set1_epi64x((long long)leftShifts[i].mask);
+        __m128i p = _mm_and_si128(e, m);
+        __m128i g = g0;
+        g = _mm_or_si128(g, _mm_and_si128(p, _mm_sll_epi64(g, s1)));
+        p = _mm_and_si128(p, _mm_sll_epi64(p, s1));
+        g = _mm_or_si128(g, _mm_and_si128(p, _mm_sll_epi64(g, s2)));
+        p = _mm_and_si128(p, _mm_sll_epi64(p, s2));
+        g = _mm_or_si128(g, _mm_and_si128(p, _mm_sll_epi64(g, s4)));
+        acc = _mm_or_si128(acc, _mm_and_si128(_mm_sll_epi64(g, s1), m));
+
+        m = _mm_set1_epi64x((long long)rightShifts[i].mask);
+        p = _mm_and_si128(e, m);
+        g = g0;
+        g = _mm_or_si128(g, _mm_and_si128(p, _mm_srl_epi64(g, s1)));
+        p = _mm_and_si128(p, _mm_srl_epi64(p, s1));
+        g = _mm_or_si128(g, _mm_and_si128(p, _mm_srl_epi64(g, s2)));
+        p = _mm_and_si128(p, _mm_srl_epi64(p, s2));
+        g = _mm_or_si128(g, _mm_and_si128(p, _mm_srl_epi64(g, s4)));
+        acc = _mm_or_si128(acc, _mm_and_si128(_mm_srl_epi64(g, s1), m));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_and_si128(acc, e));
+}
+
+// AVX2：四条通道为 {方向 A 的双方, 方向 B 的双方}，用逐通道可变移位一次处理两个方向
+TARGET("avx2") void queenStepAvx2(const Bitboard gen[2], Bitboard empty, Bitboard out[2]) {
+    const __m256i g0 = _mm256_set_epi64x((long long)gen[1], (long long)gen[0],
+                                         (long long)gen[1], (long long)gen[0]);
+    const __m256i e = _mm256_set1_epi64x((long long)empty);
+    __m256i acc = _mm256_setzero_si256();
+    for (int i = 0; i < 4; i += 2) {
+        const Shift* dirs[2] = {leftShifts, rightShifts};
+        for (int side = 0; side < 2; ++side) {
+            const Shift& a = dirs[side][i];
+            const Shift& b = dirs[side][i + 1];
+            const __m256i m = _mm256_set_epi64x((long long)b.mask, (long long)b.mask,
+                                                (long long)a.mask, (long long)a.mask);
+            const __m256i s1 = _mm256_set_epi64x(b.amount, b.amount, a.amount, a.amount);
+            const __m256i s2 = _mm256_add_epi64(s1, s1);
+            const __m256i s4 = _mm256_add_epi64(s2, s2);
+
+            __m256i p = _mm256_and_si256(e, m);
+            __m256i g = g0;
+            if (side == 0) {
+                g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_sllv_epi64(g, s1)));
+                p = _mm256_and_si256(p, _mm256_sllv_epi64(p, s1));
+                g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_sllv_epi64(g, s2)));
+                p = _mm256_and_si256(p, _mm256_sllv_epi64(p, s2));
+                g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_sllv_epi64(g, s4)));
+                acc = _mm256_or_si256(acc, _mm256_and_si256(_mm256_sllv_epi64(g, s1), m));
+            } else {
+                g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srlv_epi64(g, s1)));
+                p = _mm256_and_si256(p, _mm256_srlv_epi64(p, s1));
+                g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srlv_epi64(g, s2)));
+                p = _mm256_and_si256(p, _mm256_srlv_epi64(p, s2));
+                g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srlv_epi64(g, s4)));
+                acc = _mm256_or_si256(acc, _mm256_and_si256(_mm256_srlv_epi64(g, s1), m));
+            }
+        }
+    }
+    alignas(32) Bitboard lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_and_si256(acc, e));
+    out[0] = lanes[0] | lanes[2];
+    out[1] = lanes[1] | lanes[3];
+}
+
+#endif // TERRITORY_X86
+
+SimdLevel detectSimd() {
+#ifdef TERRITORY_X86
+    __builtin_cpu_init();
+    // AVX2 路径的特征计算同时使用 popcnt 指令
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return SimdLevel::Avx2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::Sse2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel detectedLevel() {
+    static const SimdLevel level = detectSimd();
+    return level;
+}
+
+std::atomic<int> activeLevel{-1};   // -1: 尚未选择，使用检测结果
+
+QueenStepFn stepFunction(SimdLevel level) {
+    switch (level) {
+#ifdef TERRITORY_X86
+    case SimdLevel::Avx2: return queenStepAvx2;
+    case SimdLevel::Sse2: return queenStepSse2;
+#endif
+    default: return queenStepScalar;
+    }
+}
+
+// 2^-k
+struct HalfPowers {
+    double v[MAX_LAYERS];
+    constexpr HalfPowers() : v() {
+        double x = 1.0;
+        for (int k = 0; k < MAX_LAYERS; ++k, x /= 2) v[k] = x;
+    }
+};
+constexpr HalfPowers halfPow;
+
+// t1/t2：比较双方的距离层，更近者得 1，相等记 kappa
+FORCE_INLINE double territory(const Bitboard* a, int na, const Bitboard* b, int nb, double kappa) {
+    Bitboard reachedA = 0, reachedB = 0;
+    Bitboard closerA = 0, closerB = 0, equal = 0;
+    const int n = std::max(na, nb);
+    for (int k = 1; k <= n; ++k) {
+        Bitboard la = k <= na ? a[k] : 0;
+        Bitboard lb = k <= nb ? b[k] : 0;
+        reachedA |= la;
+        reachedB |= lb;
+        closerA |= la & ~reachedB;
+        closerB |= lb & ~reachedA;
+        equal |= la & lb;
+    }
+    return popCount(closerA) - popCount(closerB) + kappa * popCount(equal);
+}
+
+// c2 = Σ clamp((Db - Da) / 6, -1, 1)：只有一方能到达的格子记 ±1，其余按层两两相交计算
+FORCE_INLINE double kingCloseness(const Bitboard* a, int na, Bitboard reachedA,
+                                  const Bitboard* b, int nb, Bitboard reachedB) {
+    int sum = 6 * (popCount(reachedA & ~reachedB) - popCount(reachedB & ~reachedA));
+    for (int i = 1; i <= na; ++i) {
+        for (int j = 1; j <= nb; ++j) {
+            Bitboard both = a[i] & b[j];
+            if (both) sum += std::max(-6, std::min(6, j - i)) * popCount(both);
+        }
+    }
+    return sum / 6.0;
+}
+
+FORCE_INLINE Features featuresImpl(const DistanceMaps& m, int player, int sideToMove) {
+    const int p = player;
+    const int o = player ^ 1;
+    // 距离相同的格子由行棋方先到
+    const double kappa = sideToMove == player ? 0.2 : -0.2;
+    Features f;
+    f.t1 = territory(m.queen[p], m.queenLayers[p], m.queen[o], m.queenLayers[o], kappa);
+    f.t2 = territory(m.king[p], m.kingLayers[p], m.king[o], m.kingLayers[o], kappa);
+    f.c2 = kingCloseness(m.king[p], m.kingLayers[p], m.kingReached[p],
+                         m.king[o], m.kingLayers[o], m.kingReached[o]);
+
+    for (int k = 1; k <= m.queenLayers[p]; ++k) f.c1 += 2 * halfPow.v[k] * popCount(m.queen[p][k]);
+    for (int k = 1; k <= m.queenLayers[o]; ++k) f.c1 -= 2 * halfPow.v[k] * popCount(m.queen[o][k]);
+
+    for (int i = 1; i <= m.queenLayers[p]; ++i) {
+        for (int j = 1; j <= m.queenLayers[o]; ++j) {
+            Bitboard both = m.queen[p][i] & m.queen[o][j];
+            if (both) f.w += halfPow.v[std::abs(i - j)] * popCount(both);
+        }
+    }
+    return f;
+}
+
+// 特征计算以 popcount 为主：同一份代码按基线与 popcnt 指令各编译一次
+Features featuresBaseline(const DistanceMaps& m, int player, int sideToMove) {
+    return featuresImpl(m, player, sideToMove);
+}
+
+#ifdef TERRITORY_X86
+TARGET("popcnt") Features featuresPopcnt(const DistanceMaps& m, int player, int sideToMove) {
+    return featuresImpl(m, player, sideToMove);
+}
+#endif
+
+// 阶段权重：w 超过该值视为开局，此时位置特征与王步领地的权重最大
+constexpr double OPENING_W = 40.0;
+// 1 格领地折合的分数 (1 步灵活性 = 2 分)
+constexpr double SQUARE_SCORE = 4.0;
+
+} // namespace
+
+int DistanceMaps::queenDistance(int player, int sq) const {
+    for (int k = 1; k <= queenLayers[player]; ++k)
+        if (queen[player][k] & squareBB(sq)) return k;
+    return -1;
+}
+
+int DistanceMaps::kingDistance(int player, int sq) const {
+    for (int k = 1; k <= kingLayers[player]; ++k)
+        if (king[player][k] & squareBB(sq)) return k;
+    return -1;
+}
+
+SimdLevel simdLevel() {
+    int level = activeLevel.load(std::memory_order_relaxed);
+    return level < 0 ? detectedLevel() : SimdLevel(level);
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    if (int(level) > int(detectedLevel())) level = detectedLevel();
+    activeLevel.store(int(level), std::memory_order_relaxed);
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Avx2: return "avx2";
+    case SimdLevel::Sse2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+void computeDistances(const Position& pos, DistanceMaps& maps) {
+    const QueenStepFn queenStep = stepFunction(simdLevel());
+    const Bitboard empty = pos.empty();
+
+    // 皇后步：每一层从上一层新到达的格子出发
+    Bitboard frontier[2] = {pos.amazons[0], pos.amazons[1]};
+    Bitboard reached[2] = {0, 0};
+    maps.queenLayers[0] = maps.queenLayers[1] = 0;
+    for (int k = 1; k < MAX_LAYERS && (frontier[0] | frontier[1]); ++k) {
+        Bitboard next[2];
+        queenStep(frontier, empty, next);
+        for (int c = 0; c < 2; ++c) {
+            next[c] &= ~reached[c];
+            maps.queen[c][k] = next[c];
+            if (next[c]) maps.queenLayers[c] = k;
+            reached[c] |= next[c];
+            frontier[c] = next[c];
+        }
+    }
+    maps.queenReached[0] = reached[0];
+    maps.queenReached[1] = reached[1];
+
+    // 王步
+    for (int c = 0; c < 2; ++c) {
+        Bitboard front = pos.amazons[c];
+        Bitboard seen = 0;
+        int k = 0;
+        while (front && k + 1 < MAX_LAYERS) {
+            front = kingSpread(front) & empty & ~seen;
+            if (!front) break;
+            maps.king[c][++k] = front;
+            seen |= front;
+        }
+        maps.kingLayers[c] = k;
+        maps.kingReached[c] = seen;
+    }
+}
+
+Features features(const DistanceMaps& m, int player, int sideToMove) {
+#ifdef TERRITORY_X86
+    if (simdLevel() == SimdLevel::Avx2) return featuresPopcnt(m, player, sideToMove);
+#endif
+    return featuresBaseline(m, player, sideToMove);
+}
+
+Features features(const Position& pos, int player) {
+    DistanceMaps maps;
+    computeDistances(pos, maps);
+    return features(maps, player, pos.sideToMove);
+}
+
+int evaluate(const Position& pos, int player) {
+    Features f = features(pos, player);
+    // 开局 (w 大) 时距离还不能决定归属，更看重位置特征与王步领地；
+    // 双方接近隔离 (w -> 0) 时只剩皇后步领地
+    const double phase = std::min(1.0, f.w / OPENING_W);
+    double score = (1.0 - 0.6 * phase) * f.t1
+                 + 0.2 * phase * f.t2
+                 + 0.3 * phase * f.c1
+                 + 0.3 * phase * f.c2;
+    return int(std::lround(SQUARE_SCORE * score));
+}
+
+} // namespace Territory
@@ -0,0 +1,157 @@
+#include "TranspositionTable.h"
+#include <functional>
+#include <thread>
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    if (megabytes == 0) megabytes = 1;
+    // 桶数取不超过预算的 2 的幂，便于用掩码取下标
+    size_t want = megabytes * 1024 * 1024 / sizeof(Bucket);
+    size_t count = 1;
+    while (count * 2 <= want) count *= 2;
+
+    buckets.reset(new Bucket[count]);
+    bucketCount = count;
+    bucketMask = count - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; ++i) {
+        for (auto& slot : buckets[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+    resetStats();
+}
+
+uint64_t TranspositionTable::pack(const Move& move, int score, int depth, TTBound bound, uint8_t gen) {
+    uint64_t d = 0;
+    if (!move.isNull()) {
+        d |= uint64_t(move.from) | (uint64_t(move.to) << 6) | (uint64_t(move.arrow) << 12);
+        d |= 1ULL << 18;
+    }
+    d |= uint64_t(bound) << 19;
+    d |= uint64_t(depth < 0 ? 0 : (depth > 127 ? 127 : depth)) << 21;
+    d |= uint64_t(gen & GENERATION_MASK) << 28;
+    d |= uint64_t(uint32_t(score) & 0x3FFFFFFF) << 34;
+    return d;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t data) {
+    TTEntry e;
+    if (data & (1ULL << 18)) {
+        e.move.from = int8_t(data & 0x3F);
+        e.move.to = int8_t((data >> 6) & 0x3F);
+        e.move.arrow = int8_t((data >> 12) & 0x3F);
+    }
+    e.bound = TTBound((data >> 19) & 0x3);
+    e.depth = depthOf(data);
+    // 算术右移还原 30 位有符号分数
+    e.score = int(int64_t(data) >> 34);
+    return e;
+}
+
+TranspositionTable::Counter& TranspositionTable::counter() const {
+    static thread_local const size_t shard =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) % COUNTER_SHARDS;
+    return counters[shard];
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) const {
+    Counter& c = counter();
+    c.probes.fetch_add(1, std::memory_order_relaxed);
+
+    const Bucket& bucket = buckets[key & bucketMask];
+    for (const auto& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && data != 0) {
+            out = unpack(data);
+            c.hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, const Move& move, int score, int depth, TTBound bound) {
+    Bucket& bucket = buckets[key & bucketMask];
+
+    // 选择替换目标：同一局面优先；否则替换 (深度 - 年龄惩罚) 最小的条目
+    const int EMPTY_VALUE = -(1 << 30);
+    Slot* victim = nullptr;
+    int victimValue = 1 << 30;
+    for (auto& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data == 0) {
+            // 空槽优先于任何已占用的条目
+            if (victimValue > EMPTY_VALUE) {
+                victim = &slot;
+                victimValue = EMPTY_VALUE;
+            }
+            continue;
+        }
+        if ((check ^ data) == key) {
+            // 同一局面：只有当新结果不比旧结果浅太多 (或为精确值/旧代) 时才覆盖
+            TTEntry old = unpack(data);
+            if (depth + 2 < old.depth && bound != TTBound::Exact && generationOf(data) == generation)
+                return;
+            Move keep = move;
+            if (keep.isNull()) keep = old.move; // 保留已知的最佳走法
+            victim = &slot;
+            uint64_t d = pack(keep, score, depth, bound, generation);
+            victim->data.store(d, std::memory_order_relaxed);
+            victim->check.store(key ^ d, std::memory_order_relaxed);
+            counter().stores.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        int age = (generation - generationOf(data)) & GENERATION_MASK;
+        int value = depthOf(data) - 8 * age;
+        if (value < victimValue) {
+            victim = &slot;
+            victimValue = value;
+        }
+    }
+
+    uint64_t d = pack(move, score, depth, bound, generation);
+    victim->data.store(d, std::memory_order_relaxed);
+    victim->check.store(key ^ d, std::memory_order_relaxed);
+    counter().stores.fetch_add(1, std::memory_order_relaxed);
+}
+
+TTStats TranspositionTable::stats() const {
+    TTStats s;
+    for (const auto& c : counters) {
+        s.probes += c.probes.load(std::memory_order_relaxed);
+        s.hits += c.hits.load(std::memory_order_relaxed);
+        s.stores += c.stores.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+void TranspositionTable::resetStats() {
+    for (auto& c : counters) {
+        c.probes.store(0, std::memory_order_relaxed);
+        c.hits.store(0, std::memory_order_relaxed);
+        c.stores.store(0, std::memory_order_relaxed);
+    }
+}
+
+int TranspositionTable::hashfull() const {
+    size_t sample = bucketCount < 1000 ? bucketCount : 1000;
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        for (const auto& slot : buckets[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (data != 0 && generationOf(data) == generation) ++used;
+        }
+    }
+    return sample ? int(used * 1000 / (sample * BUCKET_SIZE)) : 0;
+}
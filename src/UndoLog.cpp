@@ -0,0 +1,118 @@
+#include "UndoLog.h"
+
+using namespace Bitboards;
+
+void UndoLog::reset(const Position& start) {
+    records.clear();
+    checkpoints.assign(1, start);
+    cursor = 0;
+}
+
+void UndoLog::push(const PlyRecord& rec) {
+    // 新的走子使游标之后的重做记录 (及其检查点) 失效
+    records.resize(cursor);
+    size_t keep = size_t(cursor / CHECKPOINT_INTERVAL + 1);
+    if (checkpoints.size() > keep) checkpoints.resize(keep);
+    records.push_back(rec);
+    ++cursor;
+}
+
+void UndoLog::complete(int arrow, const Position& after) {
+    if (records.empty() || records.back().complete()) return;
+    records.back().arrow = int8_t(arrow);
+    size_t n = records.size();
+    if (n % CHECKPOINT_INTERVAL == 0 && checkpoints.size() == n / CHECKPOINT_INTERVAL)
+        checkpoints.push_back(after);
+}
+
+bool UndoLog::undo(PlyRecord& out) {
+    if (cursor == 0) return false;
+    out = records[cursor - 1];
+    if (!out.complete()) records.pop_back(); // 未完成的回合只能撤销，不能重做
+    --cursor;
+    return true;
+}
+
+bool UndoLog::redo(PlyRecord& out) {
+    if (cursor >= int(records.size()) || !records[cursor].complete()) return false;
+    out = records[cursor++];
+    return true;
+}
+
+int UndoLog::completedPlies() const {
+    int n = int(records.size());
+    if (n > 0 && !records.back().complete()) --n;
+    return n;
+}
+
+Position UndoLog::positionAt(int n) const {
+    int k = n / CHECKPOINT_INTERVAL;
+    if (k >= int(checkpoints.size())) k = int(checkpoints.size()) - 1;
+    Position pos = checkpoints[k];
+    for (int i = k * CHECKPOINT_INTERVAL; i < n; ++i) pos.makeMove(records[i].move());
+    return pos;
+}
+
+bool UndoLog::seek(int n) {
+    if (n < 0 || n > completedPlies()) return false;
+    if (!records.empty() && !records.back().complete()) records.pop_back();
+    cursor = n;
+    return true;
+}
+
+void UndoLog::assign(const std::vector<PlyRecord>& recs, int plyCursor) {
+    records = recs;
+    cursor = plyCursor < 0 ? 0 : (plyCursor > int(records.size()) ? int(records.size()) : plyCursor);
+}
+
+bool UndoLog::rebuild(const Position& current) {
+    auto inRange = [](int sq) { return sq >= 0 && sq < 64; };
+    for (size_t i = 0; i < records.size(); ++i) {
+        const PlyRecord& r = records[i];
+        bool last = i + 1 == records.size();
+        // 未完成的回合只能是最后一条，且正处于游标位置
+        bool shapeOk = inRange(r.from) && inRange(r.to)
+                    && (r.complete() ? inRange(r.arrow) : last && cursor == int(records.size()));
+        if (!shapeOk) {
+            reset(current);
+            return false;
+        }
+    }
+
+    // 从游标处的局面反推第 0 回合
+    Position pos = current;
+    for (int i = cursor - 1; i >= 0; --i) {
+        const PlyRecord& r = records[i];
+        if (r.complete()) pos.unmakeMove(r.move());
+        else pos.moveAmazon(pos.sideToMove, r.to, r.from);
+    }
+    Position start = pos;
+
+    // 正向重放：逐条校验合法性并重建检查点
+    checkpoints.assign(1, start);
+    for (size_t i = 0; i < records.size(); ++i) {
+        const PlyRecord& r = records[i];
+        if (int(i) == cursor && pos.hash != current.hash) break;
+        if (!(pos.amazons[pos.sideToMove] & squareBB(r.from)) || !(pos.reachable(r.from) & squareBB(r.to)))
+            break;
+        if (r.complete()) {
+            // 与 AmazonEngine::placeArrow 的规则一致：箭只需落在空格上
+            pos.moveAmazon(pos.sideToMove, r.from, r.to);
+            bool arrowOk = !pos.isOccupied(r.arrow);
+            pos.moveAmazon(pos.sideToMove, r.to, r.from);
+            if (!arrowOk) break;
+            pos.makeMove(r.move());
+            if ((i + 1) % CHECKPOINT_INTERVAL == 0) checkpoints.push_back(pos);
+        } else {
+            pos.moveAmazon(pos.sideToMove, r.from, r.to);
+        }
+        if (i + 1 == records.size()) {
+            if (cursor == int(records.size()) && pos.hash != current.hash) break;
+            return true;
+        }
+    }
+    if (records.empty()) return true;
+
+    reset(current);
+    return false;
+}
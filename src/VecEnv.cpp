@@ -0,0 +1,255 @@
+#include "VecEnv.h"
+#include "Regions.h"
+#include <algorithm>
+
+using namespace Bitboards;
+
+namespace {
+
+uint64_t nextRandom(uint64_t& s) {
+    // xorshift64*
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return s * 0x2545F4914F6CDD1DULL;
+}
+
+uint64_t splitmix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// b 中第 k 个 (从 0 起) 置位的格子
+int nthSquare(Bitboard b, int k) {
+    while (k--) b &= b - 1;
+    return lsb(b);
+}
+
+// 每个线程处理的段按 64 局对齐，避免相邻线程写同一条缓存行
+const int CHUNK_ALIGN = 64;
+
+} // namespace
+
+VecEnv::VecEnv(int n, const VecEnvOptions& options)
+    : count(std::max(1, n)), opts(options) {
+    amazonBuf[0].resize(count);
+    amazonBuf[1].resize(count);
+    arrowBuf.resize(count);
+    sideBuf.resize(count);
+    plyBuf.resize(count);
+    rngBuf.resize(count);
+    rewardBuf.resize(count);
+    doneBuf.resize(count);
+    winnerBuf.resize(count);
+    lengthBuf.resize(count);
+    for (int i = 0; i < count; ++i) rngBuf[i] = splitmix(opts.seed * 0x100000001B3ULL + uint64_t(i)) | 1;
+
+    opts.threads = std::max(1, std::min(opts.threads, (count + CHUNK_ALIGN - 1) / CHUNK_ALIGN));
+    for (int t = 1; t < opts.threads; ++t) workers.emplace_back(&VecEnv::workerLoop, this, t);
+    reset();
+}
+
+VecEnv::~VecEnv() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+// ==================== 线程池 ====================
+
+void VecEnv::parallelFor(const std::function<void(int, int)>& fn) const {
+    if (workers.empty()) {
+        fn(0, count);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        job = &fn;
+        pending = int(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    const int chunk = ((count + opts.threads - 1) / opts.threads + CHUNK_ALIGN - 1) / CHUNK_ALIGN * CHUNK_ALIGN;
+    fn(0, std::min(count, chunk));
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    finished.wait(lock, [this]() { return pending == 0; });
+    job = nullptr;
+}
+
+void VecEnv::workerLoop(int id) {
+    uint64_t seen = 0;
+    for (;;) {
+        const std::function<void(int, int)>* fn;
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            wake.wait(lock, [&]() { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+            fn = job;
+        }
+        const int chunk = ((count + opts.threads - 1) / opts.threads + CHUNK_ALIGN - 1) / CHUNK_ALIGN * CHUNK_ALIGN;
+        const int begin = std::min(count, id * chunk);
+        (*fn)(begin, std::min(count, begin + chunk));
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (--pending == 0) finished.notify_one();
+        }
+    }
+}
+
+// ==================== 对局 ====================
+
+void VecEnv::reset() {
+    parallelFor([this](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            resetOne(i);
+            rewardBuf[i] = 0;
+            doneBuf[i] = 0;
+            winnerBuf[i] = -1;
+            lengthBuf[i] = 0;
+        }
+    });
+}
+
+void VecEnv::resetOne(int i) {
+    const Position start = Position::startPosition();
+    amazonBuf[0][i] = start.amazons[0];
+    amazonBuf[1][i] = start.amazons[1];
+    arrowBuf[i] = start.arrows;
+    sideBuf[i] = uint8_t(start.sideToMove);
+    plyBuf[i] = 0;
+    // 随机开局：走到一半无子可动时就停在那里 (下一步由调用方走出判负的局面)
+    for (int k = 0; k < opts.randomOpeningPlies; ++k) {
+        const int us = sideBuf[i];
+        if (!(kingSpread(amazonBuf[us][i]) & ~(amazonBuf[0][i] | amazonBuf[1][i] | arrowBuf[i]))) break;
+        const Move m = unpackAction(sampleOne(i));
+        amazonBuf[us][i] ^= squareBB(m.from) | squareBB(m.to);
+        arrowBuf[i] |= squareBB(m.arrow);
+        sideBuf[i] = uint8_t(us ^ 1);
+        ++plyBuf[i];
+    }
+}
+
+void VecEnv::stepOne(int i, uint32_t action) {
+    const int us = sideBuf[i];
+    const Move m = unpackAction(action);
+    const Bitboard occ = amazonBuf[0][i] | amazonBuf[1][i] | arrowBuf[i];
+    const Bitboard from = squareBB(m.from), to = squareBB(m.to);
+
+    int winner = -1;
+    float reward = 0;
+    if (!(amazonBuf[us][i] & from) || !(queenAttacks(m.from, occ) & to)
+        || !(queenAttacks(m.to, occ ^ from ^ to) & squareBB(m.arrow))) {
+        winner = us ^ 1;
+        reward = -1;
+    } else {
+        amazonBuf[us][i] ^= from | to;
+        arrowBuf[i] |= squareBB(m.arrow);
+        sideBuf[i] = uint8_t(us ^ 1);
+        ++plyBuf[i];
+        const Bitboard empty = ~(amazonBuf[0][i] | amazonBuf[1][i] | arrowBuf[i]);
+        if (!(kingSpread(amazonBuf[us ^ 1][i]) & empty)) {
+            winner = us;
+        } else if (opts.adjudicate) {
+            const Position pos = position(i);
+            if (Regions::separated(pos)) {
+                Regions::Outcome outcome = Regions::decide(pos);
+                if (outcome.decided) winner = outcome.winner;
+            }
+        }
+        if (winner != -1) reward = winner == us ? 1.0f : -1.0f;
+    }
+
+    rewardBuf[i] = reward;
+    doneBuf[i] = winner != -1;
+    if (winner != -1) {
+        winnerBuf[i] = int8_t(winner);
+        lengthBuf[i] = plyBuf[i];
+        resetOne(i);
+    }
+}
+
+void VecEnv::step(const uint32_t* actions) {
+    parallelFor([this, actions](int begin, int end) {
+        for (int i = begin; i < end; ++i) stepOne(i, actions[i]);
+    });
+}
+
+uint32_t VecEnv::sampleOne(int i) {
+    const int us = sideBuf[i];
+    const Bitboard occ = amazonBuf[0][i] | amazonBuf[1][i] | arrowBuf[i];
+    int squares[4], n = 0;
+    Bitboard targets[4];
+    for (Bitboard b = amazonBuf[us][i]; b;) {
+        int sq = popLsb(b);
+        Bitboard t = queenAttacks(sq, occ);
+        if (t) {
+            squares[n] = sq;
+            targets[n++] = t;
+        }
+    }
+    // 无子可动：返回一个不合法的走法，step 时判负
+    if (n == 0) return 0;
+    const int k = int(nextRandom(rngBuf[i]) % uint64_t(n));
+    const int from = squares[k];
+    const int to = nthSquare(targets[k], int(nextRandom(rngBuf[i]) % uint64_t(popCount(targets[k]))));
+    const Bitboard arrows = queenAttacks(to, occ ^ squareBB(from) ^ squareBB(to));
+    const int arrow = nthSquare(arrows, int(nextRandom(rngBuf[i]) % uint64_t(popCount(arrows))));
+    return packAction({int8_t(from), int8_t(to), int8_t(arrow)});
+}
+
+void VecEnv::sampleActions(uint32_t* out) {
+    parallelFor([this, out](int begin, int end) {
+        for (int i = begin; i < end; ++i) out[i] = sampleOne(i);
+    });
+}
+
+// ==================== 观测 ====================
+
+void VecEnv::writePlanes(float* out) const {
+    parallelFor([this, out](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const int us = sideBuf[i];
+            const Bitboard planes[PLANES] = {amazonBuf[us][i], amazonBuf[us ^ 1][i], arrowBuf[i]};
+            float* dst = out + size_t(i) * PLANES * 64;
+            for (int p = 0; p < PLANES; ++p)
+                for (int sq = 0; sq < 64; ++sq) dst[p * 64 + sq] = float((planes[p] >> sq) & 1);
+        }
+    });
+}
+
+void VecEnv::writeMoveMasks(uint8_t* out) const {
+    parallelFor([this, out](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            uint8_t* dst = out + size_t(i) * MOVE_MASK_SIZE;
+            std::fill(dst, dst + MOVE_MASK_SIZE, uint8_t(0));
+            const Bitboard occ = amazonBuf[0][i] | amazonBuf[1][i] | arrowBuf[i];
+            for (Bitboard b = amazonBuf[sideBuf[i]][i]; b;) {
+                const int from = popLsb(b);
+                for (Bitboard t = queenAttacks(from, occ); t;) dst[from * 64 + popLsb(t)] = 1;
+            }
+        }
+    });
+}
+
+Bitboard VecEnv::arrowTargets(int i, int from, int to) const {
+    const Bitboard occ = amazonBuf[0][i] | amazonBuf[1][i] | arrowBuf[i];
+    return queenAttacks(to, occ ^ squareBB(from) ^ squareBB(to));
+}
+
+Position VecEnv::position(int i) const {
+    Position pos;
+    pos.amazons[0] = amazonBuf[0][i];
+    pos.amazons[1] = amazonBuf[1][i];
+    pos.arrows = arrowBuf[i];
+    pos.sideToMove = sideBuf[i];
+    pos.refreshHash();
+    return pos;
+}
@@ -0,0 +1,124 @@
+#include "aicontroller.h"
+
+AiController::AiController(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<FullMove>("FullMove");
+    connect(this, &AiController::searchFinished, this, &AiController::onSearchFinished, Qt::QueuedConnection);
+
+    // 搜索线程中的进度回调 -> 信号 (跨线程自动排队到 GUI 线程)
+    searchEngine.setProgressCallback([this](const SearchResult &info) {
+        emit progress(info.depth, info.score, info.nodes, info.elapsedMs);
+    });
+}
+
+AiController::~AiController()
+{
+    cancel();
+    if (worker) {
+        // 析构时本对象上排队的事件会被移除，finished 的清理槽不会再执行，直接删除
+        worker->wait();
+        delete worker;
+        worker = nullptr;
+    }
+}
+
+bool AiController::startSearch(const Position &pos, int player, const SearchLimits &limits)
+{
+    if (pondering) {
+        pondering = false;
+        ++stats.attempts;
+        Position actual = pos;
+        actual.setSideToMove(player);
+        if (ponderKey.load() == actual.hash) {
+            // ponder hit：后台搜索的正是当前局面，清除标志后按正常计时继续
+            ++stats.hits;
+            ponderFlag.store(false);
+            if (ponderDone) emit searchFinished(ticket, ponderResult);
+            return true;
+        }
+    }
+
+    if (worker) {
+        // 上一次搜索已被取消，只需等它从最近一次节点检查处返回
+        cancelAndWait();
+    }
+
+    cancelFlag.store(false);
+    quint64 myTicket = ++ticket;
+    SearchLimits lim = limits;
+    lim.cancel = &cancelFlag;
+
+    launch([this, pos, player, lim, myTicket]() {
+        FullMove move = searchEngine.getBestMove(pos, player, lim);
+        emit searchFinished(myTicket, move);
+    });
+    return false;
+}
+
+void AiController::startPondering(const Position &pos, int opponent, const SearchLimits &limits)
+{
+    if (worker) cancelAndWait();
+
+    cancelFlag.store(false);
+    ponderFlag.store(true);
+    ponderKey.store(0);
+    pondering = true;
+    ponderDone = false;
+    quint64 myTicket = ++ticket;
+    SearchLimits lim = limits;
+    lim.cancel = &cancelFlag;
+    lim.ponder = &ponderFlag;
+
+    launch([this, pos, opponent, lim, myTicket]() {
+        Move reply = searchEngine.predictReply(pos, opponent, &cancelFlag);
+        if (reply.isNull()) return;
+        Position next = pos;
+        next.setSideToMove(opponent);
+        next.makeMove(reply);
+        ponderKey.store(next.hash);
+        FullMove move = searchEngine.getBestMove(next, opponent ^ 1, lim);
+        emit searchFinished(myTicket, move);
+    });
+}
+
+void AiController::launch(const std::function<void()> &job)
+{
+    worker = QThread::create(job);
+    QThread *thread = worker;
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        if (worker == thread) worker = nullptr;
+        thread->deleteLater();
+    });
+    thread->start();
+}
+
+void AiController::cancel()
+{
+    // 使旧的 ticket 失效：即使结果已经在事件队列里也会被丢弃
+    ++ticket;
+    cancelFlag.store(true);
+    pondering = false;
+}
+
+void AiController::cancelAndWait()
+{
+    cancel();
+    if (worker) {
+        // 线程对象由 finished 的清理槽 deleteLater，这里只等待其退出
+        worker->wait();
+        worker = nullptr;
+    }
+}
+
+void AiController::onSearchFinished(quint64 finishedTicket, const FullMove &move)
+{
+    if (finishedTicket != ticket || cancelFlag.load()) return;
+    if (pondering) {
+        // 对手还没走，先保存结果，命中时再交出
+        ponderDone = true;
+        ponderResult = move;
+        return;
+    }
+    emit moveReady(move);
+}
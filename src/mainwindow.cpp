@@ -6,12 +6,23 @@
 #include <QInputDialog>
 #include <QDateTime>
 #include <QDir>
-#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
 
 MainWindow::MainWindow(QWidget *parent, bool vsAI)
     : QMainWindow(parent), isPvE(vsAI), aiThinking(false)
 {
     setWindowTitle("Amazon Chess");
+
+    // AI 搜索使用全部核心 (Lazy SMP)，结果与进度通过信号回到 GUI 线程
+    aiController = new AiController(this);
+    aiController->engine().setThreads(QThread::idealThreadCount());
+    // 可选的孤立区域残局库 (tools/tbgen 生成)，没有时按步数上下界判定
+    aiController->engine().loadTablebase("tablebase.amzt");
+    // 可选的开局库 (tools/bookgen 生成)，只做 mmap，不增加启动时间
+    aiController->engine().loadBook("book.amzo");
+    connect(aiController, &AiController::progress, this, &MainWindow::onAIProgress);
+    connect(aiController, &AiController::moveReady, this, &MainWindow::onAIMoveReady);
     resize(800, 800);
     setMinimumSize(600, 600);
     
@@ -33,6 +44,12 @@ MainWindow::MainWindow(QWidget *parent, bool vsAI)
     btnUndo->setStyleSheet(btnStyle);
     connect(btnUndo, &QPushButton::clicked, this, &MainWindow::onUndo);
 
+    QPushButton *btnRedo = new QPushButton("Redo", this);
+    btnRedo->setGeometry(460, 20, 100, 35); // Adjust position
+    btnRedo->setCursor(Qt::PointingHandCursor);
+    btnRedo->setStyleSheet(btnStyle);
+    connect(btnRedo, &QPushButton::clicked, this, &MainWindow::onRedo);
+
     QPushButton *btnSave = new QPushButton("Save", this);
     btnSave->setGeometry(570, 20, 100, 35); // Adjust position
     btnSave->setCursor(Qt::PointingHandCursor);
@@ -53,10 +70,62 @@ MainWindow::MainWindow(QWidget *parent, bool vsAI)
     );
     
     updateTurnInfo();
+    startJournal();
 }
 
 MainWindow::~MainWindow()
 {
+    // 窗口正常销毁 (非崩溃) 时日志不再需要
+    engine.setJournal(nullptr);
+    journal.discard();
+}
+
+void MainWindow::startJournal() {
+    // 每局一个日志文件，以当前对局为起点快照；之后每步由后台线程追加
+    engine.setJournal(nullptr);
+    journal.discard();
+
+    QDir dir("saves/journal");
+    if (!dir.exists()) dir.mkpath(".");
+    QString name = "game_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz") + ".amzj";
+
+    AmazonBoard board = engine.getBoard();
+    board.mode = isPvE ? "pve" : "pvp";
+    if (journal.open(dir.absoluteFilePath(name).toStdString(), AmazonPersistence::encodeBinary(board))) {
+        engine.setJournal(&journal);
+    }
+}
+
+bool MainWindow::recoverGame(const QString &journalPath) {
+    std::vector<uint8_t> snapshot;
+    std::vector<JournalEntry> entries;
+    if (!GameJournal::read(journalPath.toStdString(), snapshot, entries)) return false;
+
+    AmazonBoard board;
+    if (!AmazonPersistence::loadBoardBinary(board, snapshot.data(), snapshot.size())) return false;
+
+    isPvE = board.mode == "pve";
+    engine.setJournal(nullptr);
+    engine.setBoard(board);
+    engine.replay(entries);
+
+    // 崩溃发生在走子与射箭之间：恢复到等待射箭的状态
+    const UndoLog &log = engine.getBoard().history;
+    if (log.ply() > 0 && !log.at(log.ply() - 1).complete()) {
+        isShooting = true;
+        selectedPiece = GameLogic::fromPosKey(log.at(log.ply() - 1).to);
+    }
+
+    // 以恢复后的局面开始新的日志，再删除旧日志
+    startJournal();
+    QFile::remove(journalPath);
+
+    updateTurnInfo();
+    update();
+    if (isPvE && engine.getBoard().currentPlayer == 0 && engine.getBoard().status != "finished" && !isShooting) {
+        QTimer::singleShot(500, this, &MainWindow::runAITurn);
+    }
+    return true;
 }
 
 void MainWindow::showMessage(const QString &msg, bool isError) {
@@ -86,6 +155,9 @@ void MainWindow::updateTurnInfo() {
 }
 
 void MainWindow::onUndo() {
+    // 中断正在进行的 AI 搜索或后台思考，结果会被丢弃
+    aiController->cancel();
+    aiThinking = false;
     if (engine.undo()) {
         // 重置 UI 状态
         isMoving = false;
@@ -98,6 +170,20 @@ void MainWindow::onUndo() {
     }
 }
 
+void MainWindow::onRedo() {
+    aiController->cancel();
+    aiThinking = false;
+    if (engine.redo()) {
+        isMoving = false;
+        isShooting = false;
+        selectedPiece = {-1, -1};
+        updateTurnInfo();
+        update();
+    } else {
+        showMessage("No moves to redo", true);
+    }
+}
+
 void MainWindow::onSaveGame() {
     QString defaultName = "game_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
     bool ok;
@@ -108,7 +194,7 @@ void MainWindow::onSaveGame() {
         QDir dir("saves");
         if (!dir.exists()) dir.mkpath(".");
         
-        QString filePath = dir.absoluteFilePath(text + ".json");
+        QString filePath = dir.absoluteFilePath(text + ".amzb");
         const AmazonBoard& board = engine.getBoard();
         if (AmazonPersistence::saveBoard(board, filePath)) {
             showMessage("Game Saved: " + text);
@@ -121,7 +207,10 @@ void MainWindow::onSaveGame() {
 bool MainWindow::loadGame(const QString &filePath) {
     AmazonBoard board;
     if (AmazonPersistence::loadBoard(board, filePath)) {
+        aiController->cancel();
+        aiThinking = false;
         engine.setBoard(board);
+        startJournal();
         updateTurnInfo();
         update();
         
@@ -136,6 +225,11 @@ bool MainWindow::loadGame(const QString &filePath) {
 }
 
 void MainWindow::closeEvent(QCloseEvent *event) {
+    aiController->cancelAndWait();
+    aiThinking = false;
+    // 正常关闭不需要恢复，删除日志
+    engine.setJournal(nullptr);
+    journal.discard();
     emit gameClosed();
     QMainWindow::closeEvent(event);
 }
@@ -275,36 +369,62 @@ void MainWindow::drawHighlights(QPainter &painter) {
 }
 
 void MainWindow::runAITurn() {
-    if (!isPvE) return;
+    if (!isPvE || aiThinking) return;
     const AmazonBoard& board = engine.getBoard();
     
     // 假设 AI 执蓝方 (0), 玩家执红方 (1)
-    if (board.currentPlayer == 0) {
+    if (board.currentPlayer == 0 && board.status != "finished") {
         aiThinking = true;
         statusLabel->setText("AI (Blue) is thinking...");
-        QCoreApplication::processEvents(); // 刷新 UI
 
-        // 运行 AI 搜索
-        FullMove aiMove = aiEngine.getBestMove(board, 0);
-        
-        // 执行移动
-        MoveResult mRes = engine.movePiece(aiMove.from, aiMove.to);
-        if (mRes.success) {
-             // AI 射箭
-             MoveResult sRes = engine.placeArrow(aiMove.arrow);
-             if (sRes.winner != -1) {
-                QString wName = (sRes.winner == 1) ? "Red" : "Blue/AI";
-                showMessage("Game Over! " + wName + " Wins!");
-             } else {
-                 updateTurnInfo();
-             }
-        } else {
-            showMessage("AI Error: " + mRes.message, true);
+        // 异步搜索：到期 (timeMs) 时返回已找到的最佳走法，GUI 线程立即返回
+        SearchLimits limits;
+        limits.timeMs = SearchEngine::DEFAULT_TIME_MS;
+        if (aiController->startSearch(engine.getPosition(), 0, limits)) {
+            const PonderStats &ps = aiController->ponderStats();
+            statusLabel->setText(QString("AI (Blue) is thinking... ponder hit (%1% hit rate)")
+                                 .arg(qRound(ps.hitRate() * 100)));
         }
+    }
+}
 
-        aiThinking = false;
-        update();
+void MainWindow::startPondering() {
+    if (!isPvE || engine.getBoard().status == "finished") return;
+
+    // 玩家思考期间，AI 在预测的玩家走法之后的局面上提前搜索
+    SearchLimits limits;
+    limits.timeMs = SearchEngine::DEFAULT_TIME_MS;
+    aiController->startPondering(engine.getPosition(), 1, limits);
+}
+
+void MainWindow::onAIProgress(int depth, int score, quint64 nodes, int elapsedMs) {
+    Q_UNUSED(score);
+    if (!aiThinking) return;
+    QString detail = depth > 0 ? QString("depth %1").arg(depth) : QString("%1 playouts").arg(nodes);
+    statusLabel->setText(QString("AI (Blue) is thinking... %1, %2 ms").arg(detail).arg(elapsedMs));
+}
+
+void MainWindow::onAIMoveReady(const FullMove &aiMove) {
+    if (!aiThinking) return;
+    aiThinking = false;
+
+    // 执行移动
+    MoveResult mRes = engine.movePiece(aiMove.from, aiMove.to);
+    if (mRes.success) {
+         // AI 射箭
+         MoveResult sRes = engine.placeArrow(aiMove.arrow);
+         if (sRes.winner != -1) {
+            QString wName = (sRes.winner == 1) ? "Red" : "Blue/AI";
+            showMessage("Game Over! " + wName + " Wins!");
+         } else {
+             updateTurnInfo();
+             startPondering();
+         }
+    } else {
+        showMessage("AI Error: " + mRes.message, true);
     }
+
+    update();
 }
 
 void MainWindow::mousePressEvent(QMouseEvent *event) {
@@ -321,7 +441,7 @@ void MainWindow::mousePressEvent(QMouseEvent *event) {
     // 简单的状态机逻辑
     if (!isMoving && !isShooting) {
         // 阶段1: 选择棋子
-        int pieceUser = board.getPieceAt(clicked.col, clicked.row);
+        int pieceUser = engine.getPosition().pieceAt(GameLogic::getPosKey(clicked));
         if (pieceUser != -1) {
             if (pieceUser == board.currentPlayer) {
                 selectedPiece = clicked;
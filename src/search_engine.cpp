@@ -1,221 +1,656 @@
 #include "search_engine.h"
-#include <QtGlobal>
-#include <QTime>
+#include "Evaluation.h"
+#include "Territory.h"
+#include "MctsEngine.h"
+#include "MovePicker.h"
+#include "Regions.h"
+#include "AllocCounter.h"
 #include <algorithm>
-#include <random>
+#include <iterator>
+#include <thread>
 #include <cmath>
-#include <QDebug>
-#include <QRandomGenerator>
-
-SearchEngine::SearchEngine() {
-    // 初始化中心权重 (越靠近中心分越高)
-    for(int r=0; r<8; ++r) {
-        for(int c=0; c<8; ++c) {
-            // 简单的中心距离计算
-            double dist = std::sqrt(std::pow(r - 3.5, 2) + std::pow(c - 3.5, 2));
-            centerWeights[c][r] = 8 - (int)dist; 
-        }
-    }
-}
+#include <random>
 
-// 辅助：深拷贝移动
-void applyMove(AmazonBoard& board, const FullMove& move) {
-    // 1. Move Piece
-    for(auto& p : board.pieces) {
-        if(p.col == move.from.col && p.row == move.from.row) {
-            p.col = move.to.col;
-            p.row = move.to.row;
-            break;
-        }
-    }
-    // 2. Place Arrow
-    board.blocks.push_back(move.arrow);
-}
+using namespace Bitboards;
 
-// 获取某个位置的所有可达点 (Queen moves)
-QVector<Point> getReachable(const AmazonBoard& board, Point p) {
-    QVector<Point> moves;
-    static const int dirs[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
-    
-    // 为了效率，构建临时 occupied set
-    // 注意：实际高频调用时应传入 set 或 grid 数组，这里为了代码简洁直接遍历
-    // 优化：使用简单的 8x8 bool 数组
-    bool occupied[8][8] = {false};
-    for(const auto& pc : board.pieces) occupied[pc.col][pc.row] = true;
-    for(const auto& bk : board.blocks) occupied[bk.col][bk.row] = true;
-
-    for(int i=0; i<8; ++i) {
-        int x = p.col;
-        int y = p.row;
-        while(true) {
-            x += dirs[i][0];
-            y += dirs[i][1];
-            if(x < 0 || x >= 8 || y < 0 || y >= 8) break;
-            if(occupied[x][y]) break;
-            moves.push_back({x, y});
-        }
-    }
-    return moves;
+SearchEngine::SearchEngine() {
+    std::random_device rd;
+    bookRandom = (uint64_t(rd()) << 32 | rd()) | 1;
 }
 
-double SearchEngine::evaluate(const AmazonBoard& board, int player) {
-    double score = 0;
-    
-    // 1. 灵活性 (Mobility) - 简单计算每个棋子的可移动步数
-    int myMobility = 0;
-    int oppMobility = 0;
-
-    for(const auto& p : board.pieces) {
-        int moves = getReachable(board, {p.col, p.row}).size();
-        if(p.user == player) {
-            myMobility += moves;
-            // 2. 中心控制 (Center Control) - 前期权重较大
-            score += centerWeights[p.col][p.row] * 0.5;
-        } else {
-            oppMobility += moves;
-            score -= centerWeights[p.col][p.row] * 0.5;
-        }
-    }
-
-    score += (myMobility - oppMobility);
-    return score;
+static Point toPoint(int sq) {
+    return {colOf(sq), rowOf(sq)};
 }
 
-// 蒙特卡洛/随机模拟：从当前局面快速走 N 步，看谁更有利
-double SearchEngine::runMonteCarlo(AmazonBoard board, int player, int depth) {
-    int simPlayer = player; 
-    // 简单的随机模拟
-    // 由于性能原因，我们只模拟几步，而不是走到终局
-    for(int d=0; d<depth; ++d) {
-        // 随机选一个棋子
-        QVector<int> myIndices;
-        for(int i=0; i<board.pieces.size(); ++i) {
-            if(board.pieces[i].user == simPlayer) myIndices.push_back(i);
-        }
-        if(myIndices.isEmpty()) return -1000; // 输了
-
-        // 随机移动
-        int pIdx = myIndices[QRandomGenerator::global()->bounded(myIndices.size())];
-        Piece& p = board.pieces[pIdx];
-        
-        QVector<Point> moves = getReachable(board, {p.col, p.row});
-        if(moves.isEmpty()) return (simPlayer == player) ? -1000 : 1000;
-
-        Point to = moves[QRandomGenerator::global()->bounded(moves.size())];
-        Point from = {p.col, p.row};
-        p.col = to.col;
-        p.row = to.row;
-
-        // 随机射箭
-        QVector<Point> arrowOps = getReachable(board, to);
-        if(arrowOps.isEmpty()) return (simPlayer == player) ? -1000 : 1000;
-        Point arrow = arrowOps[QRandomGenerator::global()->bounded(arrowOps.size())];
-        board.blocks.push_back(arrow);
-
-        simPlayer = 1 - simPlayer;
-    }
-    return evaluate(board, player);
+// 获取某个位置的所有可达点 (Queen moves)，直接查射线表，无需重建占用网格
+static Bitboard getReachable(const Position& pos, int sq) {
+    return pos.reachable(sq);
 }
 
-FullMove SearchEngine::getBestMove(const AmazonBoard& board, int player) {
-    
+FullMove SearchEngine::getBeamMove(const Position& pos, int player) {
 
-    QVector<FullMove> candidates;
+    // 走子候选最多 4 * 27 个，放在栈上
+    const MoveOrdering& ordering = mainOrdering();
+    FullMove candidates[MoveList::MAX_PIECES * MoveList::MAX_QUEEN_MOVES];
+    int candidateCount = 0;
     
     // Step 1: Generate Queen Moves
-    for(const auto& p : board.pieces) {
-        if(p.user != player) continue;
+    Bitboard mine = pos.amazons[player];
+    while(mine) {
+        int from = popLsb(mine);
         
-        QVector<Point> moves = getReachable(board, {p.col, p.row});
-        for(const auto& to : moves) {
-            // 快速评估：只看棋子位置变动带来的收益
-            // 模拟移动
-            AmazonBoard simBoard = board; 
-            // 注意：这里拷贝整个棋盘开销较大，应该尽量优化，但为了代码清晰暂时这样做
-            // 优化：只修改坐标进行评估，然后还原
-            // 这里为了简单，我们计算 位置分 + 灵活性
-            
-            double score = centerWeights[to.col][to.row] * 1.0; 
-            // 简单的移动启发：不要走到死路
-            // 我们可以用 SearchEngine::evaluate 粗略估算
+        Bitboard moves = getReachable(pos, from);
+        while(moves) {
+            int to = popLsb(moves);
+            // 快速评估：棋子位置变动带来的收益，加上 Alpha-Beta 搜索积累的走子历史分
+            double score = Evaluation::centerWeight(to)
+                         + ordering.queenHistory(player, from, to) / double(MoveOrdering::BASE_SCALE);
             FullMove fm;
-            fm.from = {p.col, p.row};
-            fm.to = to;
+            fm.from = toPoint(from);
+            fm.to = toPoint(to);
+            fm.arrow = {-1, -1};
             fm.score = score;
-            candidates.push_back(fm);
+            if(candidateCount < int(std::size(candidates))) candidates[candidateCount++] = fm;
         }
     }
 
     // Sort by simple score (Center + basic logic)
-    std::sort(candidates.begin(), candidates.end(), [](const FullMove& a, const FullMove& b) {
+    std::sort(candidates, candidates + candidateCount, [](const FullMove& a, const FullMove& b) {
         return a.score > b.score; 
     });
 
     // Pruning: Keep top 12 moves (Beam Search-like)
-    if(candidates.size() > 12) candidates.resize(12);
+    if(candidateCount > 12) candidateCount = 12;
 
     // Step 2: For top moves, find best Arrow
-    FullMove bestMove;
-    bestMove.score = -999999;
+    FullMove bestMove = toFullMove(Move::none(), -999999);
     bool found = false;
+    uint64_t leaves = 0;
 
-    for(auto& move : candidates) {
-        // Apply move temporarily
-        AmazonBoard simBoard = board;
-        // Fix piece position in simBoard
-        int pIdx = -1;
-        for(int i=0; i<simBoard.pieces.size(); ++i) {
-            if(simBoard.pieces[i].col == move.from.col && simBoard.pieces[i].row == move.from.row) {
-                simBoard.pieces[i].col = move.to.col;
-                simBoard.pieces[i].row = move.to.row;
-                pIdx = i;
-                break;
-            }
-        }
+    IncrementalEval eval(pos);
+    for(int c = 0; c < candidateCount; ++c) {
+        const FullMove& move = candidates[c];
+        // Apply move temporarily (局面只有 4 个字，拷贝代价可以忽略)
+        Position sim = pos;
+        int from = GameLogic::getPosKey(move.from);
+        int to = GameLogic::getPosKey(move.to);
+        sim.moveAmazon(player, from, to);
+        eval.moveAmazon(player, from, to);
 
         // Generate Arrows from new position
-        QVector<Point> arrows = getReachable(simBoard, move.to);
-        
-        // 如果射箭太耗时，我们也可以只采样部分箭
-        // 但射箭是封锁对方的关键，尽量多看
+        Bitboard arrows = getReachable(sim, to);
         
-        for(const auto& ar : arrows) {
+        // 射箭是封锁对方的关键，尽量多看
+        while(arrows) {
+            int ar = popLsb(arrows);
             // 模拟射箭
-            simBoard.blocks.push_back(ar); // Push
+            sim.placeArrow(ar);
+            eval.placeArrow(ar);
             
-            // Evaluation
-            // 混合：静态评估 + 蒙特卡洛微量模拟
-            double staticVal = evaluate(simBoard, player);
-            // double mcVal = runMonteCarlo(simBoard, player, 5); // Disable deep sim for speed
-            
-            double finalScore = staticVal;
+            // Evaluation (随机模拟已由 MCTS 后端取代)；只更新经过箭所在格的射线
+            double finalScore = eval.evaluate(player);
+            ++leaves;
 
             if(finalScore > bestMove.score) {
                 bestMove = move;
-                bestMove.arrow = ar;
+                bestMove.arrow = toPoint(ar);
                 bestMove.score = finalScore;
                 found = true;
             }
 
-            simBoard.blocks.pop_back(); // Pop
+            sim.removeArrow(ar);
+            eval.removeArrow(ar);
         }
+        eval.moveAmazon(player, to, from);
     }
 
-    if(!found && !candidates.isEmpty()) {
+    if(!found && candidateCount > 0) {
         // Fallback
         bestMove = candidates[0];
         // Find any valid arrow
-        AmazonBoard tmp = board;
-         for(auto& p : tmp.pieces) {
-            if(p.col == bestMove.from.col && p.row == bestMove.from.row) {
-                p.col = bestMove.to.col;
-                p.row = bestMove.to.row;
+        Position tmp = pos;
+        int to = GameLogic::getPosKey(bestMove.to);
+        tmp.moveAmazon(player, GameLogic::getPosKey(bestMove.from), to);
+        Bitboard ars = getReachable(tmp, to);
+        if(ars) bestMove.arrow = toPoint(lsb(ars));
+    }
+
+    totalNodes.fetch_add(leaves, std::memory_order_relaxed);
+    return bestMove;
+}
+
+// ==================== 迭代加深 Alpha-Beta (PVS) ====================
+
+FullMove SearchEngine::toFullMove(const Move& m, double score) const {
+    FullMove fm;
+    if(m.isNull()) {
+        fm.from = fm.to = fm.arrow = {-1, -1};
+    } else {
+        fm.from = toPoint(m.from);
+        fm.to = toPoint(m.to);
+        fm.arrow = toPoint(m.arrow);
+    }
+    fm.score = score;
+    return fm;
+}
+
+FullMove SearchEngine::getBestMove(const Position& pos, int player) {
+    SearchLimits defaults;
+    defaults.timeMs = DEFAULT_TIME_MS;
+    return getBestMove(pos, player, defaults);
+}
+
+// 生成全部完整走法 (走子 × 射箭)，只用于根节点 (需要在各轮迭代间调整次序)
+// 排序分取 scorer 两个阶段之和；置换表中的走法排在最前
+void SearchEngine::generateMoves(const Position& pos, MoveList& out, const MoveScorer& scorer, const Move& ttMove) {
+    out.clear();
+    int us = pos.sideToMove;
+    Bitboard mine = pos.amazons[us];
+    Position sim = pos;
+    while(mine) {
+        int from = popLsb(mine);
+        Bitboard targets = pos.reachable(from);
+        while(targets) {
+            int to = popLsb(targets);
+            sim.moveAmazon(us, from, to);
+            Bitboard arrows = sim.reachable(to);
+            sim.moveAmazon(us, to, from);
+            while(arrows) {
+                int ar = popLsb(arrows);
+                Move m = {int8_t(from), int8_t(to), int8_t(ar)};
+                int score = scorer.queenScore(pos, from, to) + scorer.arrowScore(pos, from, to, ar);
+                if(m == ttMove) score = INF_SCORE;
+                out.push(m, score);
+            }
+        }
+    }
+}
+
+// 每个节点调用一次。节点数每 1024 个汇总到共享计数器一次，同时检查时间
+bool SearchEngine::checkLimits(ThreadData& td) {
+    ++td.nodes;
+    if(stopFlag.load(std::memory_order_relaxed)) return true;
+    if((td.nodes & 1023) == 0) {
+        totalNodes.fetch_add(1024, std::memory_order_relaxed);
+        if(limits.cancel && limits.cancel->load(std::memory_order_relaxed))
+            stopFlag.store(true, std::memory_order_relaxed);
+        if(limits.timeMs && !(limits.ponder && limits.ponder->load(std::memory_order_relaxed))) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            if(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= limits.timeMs)
+                stopFlag.store(true, std::memory_order_relaxed);
+        }
+    }
+    if(limits.maxNodes) {
+        // 单线程时节点上限是精确的；多线程时按已汇总的总数加上本线程未汇总的部分估算
+        uint64_t seen = threadCount == 1 ? td.nodes
+                      : totalNodes.load(std::memory_order_relaxed) + (td.nodes & 1023);
+        if(seen >= limits.maxNodes) stopFlag.store(true, std::memory_order_relaxed);
+    }
+    return stopFlag.load(std::memory_order_relaxed);
+}
+
+// 置换表键：开局附近镜像/旋转 (或交换颜色) 后相同的局面共用一个条目，走法按规范坐标系保存
+Symmetry::Key SearchEngine::ttKey(const Position& pos) {
+    if(Bitboards::popCount(pos.arrows) <= SYMMETRY_MAX_ARROWS) return Symmetry::canonicalKey(pos);
+    Symmetry::Key key;
+    key.hash = pos.hash;
+    return key;
+}
+
+// 将死分数在置换表中以"距当前节点"的形式保存，取出时再换算回"距根节点"
+int SearchEngine::scoreToTT(int score, int ply) {
+    if(score >= MATE_SCORE - MAX_PLY) return score + ply;
+    if(score <= -MATE_SCORE + MAX_PLY) return score - ply;
+    return score;
+}
+
+int SearchEngine::scoreFromTT(int score, int ply) {
+    if(score >= MATE_SCORE - MAX_PLY) return score - ply;
+    if(score <= -MATE_SCORE + MAX_PLY) return score + ply;
+    return score;
+}
+
+int SearchEngine::search(ThreadData& td, Position& pos, int depth, int alpha, int beta, int ply) {
+    if(checkLimits(td)) return 0;
+
+    int us = pos.sideToMove;
+    // 无子可动即告负，越早输分数越低
+    if(!pos.canMove(us)) return -MATE_SCORE + ply;
+
+    // 双方已分隔且步数上下界足以定胜负：给出确定的分数，不必搜完填空阶段
+    Regions::Outcome outcome = Regions::decide(pos, tablebaseView());
+    if(outcome.decided) {
+        int score = DECIDED_SCORE + outcome.margin;
+        return outcome.winner == us ? score : -score;
+    }
+
+    // 置换表：非 PV 节点可直接截断；叶子的静态评估也会被复用
+    const bool pvNode = beta - alpha > 1;
+    const int alphaOrig = alpha;
+    const Symmetry::Key key = ttKey(pos);
+    TTEntry tte;
+    Move ttMove = Move::none();
+    if(tt.probe(key.hash, tte)) {
+        ttMove = key.fromCanonical(tte.move);
+        int ttScore = scoreFromTT(tte.score, ply);
+        if(tte.depth >= depth && (!pvNode || depth <= 0)) {
+            if(tte.bound == TTBound::Exact
+               || (tte.bound == TTBound::Lower && ttScore >= beta)
+               || (tte.bound == TTBound::Upper && ttScore <= alpha))
+                return ttScore;
+        }
+    }
+
+    if(depth <= 0 || ply >= MAX_PLY - 1) {
+        // 灵活性部分增量维护，领地部分每个叶子做一次泛洪，合计与 Evaluation::evaluate(pos, us) 相同
+        int eval = td.eval.evaluate(us) + Territory::evaluate(pos, us);
+        tt.store(key.hash, Move::none(), eval, 0, TTBound::Exact);
+        return eval;
+    }
+
+    // 分阶段生成：剪枝时未访问的走子连射箭都不会生成
+    MovePicker picker(pos, ttMove, td.ordering, td.ordering.killers(ply));
+
+    int best = -INF_SCORE;
+    Move bestMove = Move::none();
+    // 截断前搜索过的走法，截断时在历史表中降分 (只记前 MAX_TRIED 个)
+    constexpr int MAX_TRIED = 32;
+    Move tried[MAX_TRIED];
+    int i = 0;
+    for(Move m = picker.next(); !m.isNull(); m = picker.next(), ++i) {
+        pos.makeMove(m);
+        td.eval.makeMove(m);
+        int score;
+        if(i == 0) {
+            score = -search(td, pos, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            // 零窗口试探，失败高时再以完整窗口重搜
+            score = -search(td, pos, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if(score > alpha && score < beta)
+                score = -search(td, pos, depth - 1, -beta, -alpha, ply + 1);
+        }
+        pos.unmakeMove(m);
+        td.eval.unmakeMove(m);
+        if(stopFlag.load(std::memory_order_relaxed)) return 0;
+
+        if(score > best) {
+            best = score;
+            bestMove = m;
+            if(score > alpha) {
+                alpha = score;
+                if(alpha >= beta) {
+                    td.ordering.onCutoff(us, ply, depth, m, tried, std::min(i, MAX_TRIED));
+                    ++td.orderingStats.cutoffs;
+                    if(i == 0) ++td.orderingStats.firstMoveCutoffs;
+                    ++i;
+                    break;
+                }
+            }
+        }
+        if(i < MAX_TRIED) tried[i] = m;
+    }
+    ++td.orderingStats.interiorNodes;
+    td.orderingStats.movesSearched += i;
+
+    TTBound bound = best >= beta ? TTBound::Lower
+                  : (best > alphaOrig ? TTBound::Exact : TTBound::Upper);
+    tt.store(key.hash, key.toCanonical(bestMove), scoreToTT(best, ply), depth, bound);
+    return best;
+}
+
+// 根节点：与 search 相同的 PVS，但会把最佳走法移到列表最前，
+// 使下一轮迭代 (以及中途超时时) 总是先看已知最好的走法
+int SearchEngine::searchRoot(ThreadData& td, Position& pos, int depth, int alpha, int beta) {
+    MoveList& rootMoves = td.rootMoves;
+    int best = -INF_SCORE;
+    for(int i = 0; i < rootMoves.size(); ++i) {
+        const Move m = rootMoves[i].move;
+        pos.makeMove(m);
+        td.eval.makeMove(m);
+        int score;
+        if(i == 0) {
+            score = -search(td, pos, depth - 1, -beta, -alpha, 1);
+        } else {
+            score = -search(td, pos, depth - 1, -alpha - 1, -alpha, 1);
+            if(score > alpha && score < beta)
+                score = -search(td, pos, depth - 1, -beta, -alpha, 1);
+        }
+        pos.unmakeMove(m);
+        td.eval.unmakeMove(m);
+        if(stopFlag.load(std::memory_order_relaxed)) break;
+
+        if(score > best) {
+            best = score;
+            std::rotate(rootMoves.begin(), rootMoves.begin() + i, rootMoves.begin() + i + 1);
+            if(score > alpha) {
+                // 完整搜索过且抬高了 alpha：即使本轮随后被中断也可以采纳
+                alpha = score;
+                td.iterationBest = m;
+                td.iterationScore = score;
+                if(alpha >= beta) break;
+            }
+        }
+    }
+    return best;
+}
+
+// 单个线程的迭代加深主循环。主线程 (id 0) 从深度 1 开始；
+// 辅助线程错开起始深度并打乱根节点次序，借助共享置换表为主线程探路 (Lazy SMP)
+void SearchEngine::iterativeDeepening(ThreadData& td, const Position& start) {
+    Position pos = start;
+    td.eval.reset(pos);
+    td.nodes = 0;
+    td.completedDepth = 0;
+    td.bestScore = 0;
+    td.orderingStats = OrderingStats();
+
+    const Symmetry::Key rootKey = ttKey(pos);
+    TTEntry rootEntry;
+    Move rootTTMove = tt.probe(rootKey.hash, rootEntry) ? rootKey.fromCanonical(rootEntry.move) : Move::none();
+    generateMoves(pos, td.rootMoves, td.ordering, rootTTMove);
+    if(td.id > 0) {
+        // 辅助线程：给启发分加上确定性的扰动，使各线程优先展开不同的子树
+        uint64_t seed = 0x9E3779B97F4A7C15ULL * uint64_t(td.id);
+        for(auto& sm : td.rootMoves) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            if(sm.score < INF_SCORE) sm.score += int(seed % 8);
+        }
+    }
+    // 同分时按生成顺序 (起点、落点、箭依次升序) 排列，等价于稳定排序，但 std::sort 不需要临时缓冲区
+    std::sort(td.rootMoves.begin(), td.rootMoves.end(), [](const ScoredMove& a, const ScoredMove& b) {
+        if(a.score != b.score) return a.score > b.score;
+        if(a.move.from != b.move.from) return a.move.from < b.move.from;
+        if(a.move.to != b.move.to) return a.move.to < b.move.to;
+        return a.move.arrow < b.move.arrow;
+    });
+    td.best = td.rootMoves[0].move;
+
+    // 期望窗口半宽
+    const int aspirationDelta = 20;
+
+    for(int depth = 1 + (td.id & 1); depth <= limits.maxDepth; ++depth) {
+        int alpha = -INF_SCORE;
+        int beta = INF_SCORE;
+        int delta = aspirationDelta;
+        if(td.completedDepth >= 1 && std::abs(td.bestScore) < MATE_SCORE - MAX_PLY) {
+            alpha = std::max(td.bestScore - delta, -INF_SCORE);
+            beta = std::min(td.bestScore + delta, INF_SCORE);
+        }
+
+        int score;
+        td.iterationBest = Move::none();
+        while(true) {
+            score = searchRoot(td, pos, depth, alpha, beta);
+            if(stopFlag.load(std::memory_order_relaxed)) break;
+            if(score <= alpha) {
+                alpha = std::max(score - delta, -INF_SCORE);
+                delta *= 2;
+            } else if(score >= beta) {
+                beta = std::min(score + delta, INF_SCORE);
+                delta *= 2;
+            } else {
                 break;
             }
         }
-        QVector<Point> ars = getReachable(tmp, bestMove.to);
-        if(!ars.isEmpty()) bestMove.arrow = ars[0];
+
+        if(stopFlag.load(std::memory_order_relaxed)) {
+            // 未完成的迭代：采纳其中已完整搜索并抬高过 alpha 的走法
+            if(!td.iterationBest.isNull()) {
+                td.best = td.iterationBest;
+                td.bestScore = td.iterationScore;
+            }
+            break;
+        }
+
+        td.best = td.rootMoves[0].move;
+        td.bestScore = score;
+        td.completedDepth = depth;
+        if(td.id == 0) {
+            tt.store(rootKey.hash, rootKey.toCanonical(td.best), scoreToTT(score, 0), depth, TTBound::Exact);
+            if(progressCallback) {
+                SearchResult info;
+                info.best = td.best;
+                info.score = score;
+                info.depth = depth;
+                info.nodes = totalNodes.load(std::memory_order_relaxed) + (td.nodes & 1023);
+                info.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - startTime).count();
+                progressCallback(info);
+            }
+        }
+
+        // 已经找到必胜/必败 (含区域分隔后已定的胜负)，无需继续加深
+        if(std::abs(score) >= DECIDED_SCORE) break;
     }
+}
 
-    return bestMove;
+void SearchEngine::setThreads(int n) {
+    threadCount = std::max(1, std::min(n, MAX_THREADS));
+}
+
+void SearchEngine::setSolverHashMB(size_t megabytes) {
+    solverHashMB = megabytes;
+    if(solver) solver->resize(megabytes);
+}
+
+bool SearchEngine::loadBook(const std::string& path) {
+    return book.open(path);
+}
+
+bool SearchEngine::loadTablebase(const std::string& path) {
+    return tablebase.open(path);
+}
+
+void SearchEngine::setSeed(uint64_t seed) {
+    rngSeed = seed;
+    bookRandom = seed | 1;
+    if(mcts) mcts->setSeed(seed);
+}
+
+FullMove SearchEngine::getBestMove(const Position& start, int player, const SearchLimits& lim) {
+    limits = lim;
+    if(limits.maxDepth <= 0 || limits.maxDepth > MAX_PLY - 1) limits.maxDepth = MAX_PLY - 1;
+    stopFlag.store(false);
+    totalNodes.store(0);
+    startTime = std::chrono::steady_clock::now();
+    result = SearchResult();
+
+    // 开局库命中：不搜索，按权重随机取一个书中走法
+    if(useBook && book.isOpen()) {
+        Position pos = start;
+        pos.setSideToMove(player);
+        bookRandom ^= bookRandom << 13;
+        bookRandom ^= bookRandom >> 7;
+        bookRandom ^= bookRandom << 17;
+        Move m = book.data().pick(pos, bookRandom);
+        if(!m.isNull()) {
+            result.best = m;
+            result.fromBook = true;
+            result.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startTime).count();
+            return toFullMove(m, 0);
+        }
+    }
+
+    switch(backend) {
+    case SearchBackend::Beam: {
+        Position pos = start;
+        pos.setSideToMove(player);
+        FullMove fm = getBeamMove(pos, player);
+        // 与其他后端一样填好 lastResult，工具只读取 result.best
+        if(fm.arrow.col >= 0) {
+            result.best = {int8_t(GameLogic::getPosKey(fm.from)), int8_t(GameLogic::getPosKey(fm.to)),
+                           int8_t(GameLogic::getPosKey(fm.arrow))};
+            result.depth = 1;
+        }
+        result.nodes = totalNodes.load(std::memory_order_relaxed);
+        result.score = (int)fm.score;
+        result.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        return fm;
+    }
+    case SearchBackend::Mcts: {
+        if(!mcts) {
+            mcts.reset(new MctsEngine());
+            if(rngSeed) mcts->setSeed(rngSeed);
+        }
+        mcts->setOrdering(&mainOrdering());
+        mcts->setTablebase(tablebaseView());
+        if(progressCallback) {
+            mcts->setProgressCallback([this](const MctsStats& st) {
+                SearchResult info;
+                info.nodes = st.playouts;
+                info.elapsedMs = st.elapsedMs;
+                progressCallback(info);
+            });
+        } else {
+            mcts->setProgressCallback(nullptr);
+        }
+        result.best = mcts->search(start, player, limits.timeMs, limits.maxNodes, threadCount,
+                                   limits.cancel, limits.ponder);
+        const MctsStats& st = mcts->lastStats();
+        result.nodes = st.playouts;
+        result.elapsedMs = st.elapsedMs;
+        return toFullMove(result.best, 0);
+    }
+    case SearchBackend::AlphaBeta:
+    default:
+        return searchAlphaBeta(start, player);
+    }
+}
+
+Move SearchEngine::predictReply(const Position& start, int player, const std::atomic<bool>* cancel) {
+    Position pos = start;
+    pos.setSideToMove(player);
+    if(!pos.canMove(player)) return Move::none();
+
+    // 对手在书中的局面上多半会走书中最常见的走法
+    if(useBook && book.isOpen()) {
+        Move m = book.data().best(pos);
+        if(!m.isNull()) return m;
+    }
+
+    const Symmetry::Key key = ttKey(pos);
+    TTEntry entry;
+    if(tt.probe(key.hash, entry)) {
+        Move m = key.fromCanonical(entry.move);
+        if(pos.isLegal(m)) return m;
+    }
+
+    // 置换表未命中 (或哈希冲突)：浅层 Alpha-Beta 搜索，与所选后端无关
+    limits = SearchLimits();
+    limits.maxDepth = PREDICT_DEPTH;
+    limits.timeMs = PREDICT_TIME_MS;
+    limits.cancel = cancel;
+    stopFlag.store(false);
+    totalNodes.store(0);
+    startTime = std::chrono::steady_clock::now();
+    result = SearchResult();
+    searchAlphaBeta(pos, player);
+    if(cancel && cancel->load()) return Move::none();
+    return result.best;
+}
+
+void SearchEngine::ensureThreadData(int count) {
+    while((int)threadData.size() < count) {
+        threadData.emplace_back(new ThreadData());
+        threadData.back()->id = (int)threadData.size() - 1;
+    }
+}
+
+MoveOrdering& SearchEngine::mainOrdering() {
+    ensureThreadData(1);
+    return threadData[0]->ordering;
+}
+
+FullMove SearchEngine::searchAlphaBeta(const Position& start, int player) {
+    Position pos = start;
+    pos.setSideToMove(player);
+    if(!pos.canMove(player)) return toFullMove(Move::none(), -MATE_SCORE);
+    if(limits.cancel && limits.cancel->load()) stopFlag.store(true);
+
+    tt.newSearch();
+    tt.resetStats();
+
+    ensureThreadData(threadCount);
+    for(int i = 0; i < threadCount; ++i) threadData[i]->ordering.newSearch();
+
+    // 残局：此前的求解已证明必胜的局面直接走证明树中的取胜走法，不再搜索
+    const bool solving = useSolver && PnSolver::applicable(pos);
+    if(solving) {
+        if(!solver) solver.reset(new PnSolver(solverHashMB));
+        SolveResult known = solver->lookup(pos);
+        if(known.status == SolveStatus::Win) {
+            result.best = known.best;
+            result.score = DECIDED_SCORE;
+            result.solved = SolveStatus::Win;
+            result.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startTime).count();
+            return toFullMove(result.best, result.score);
+        }
+    }
+
+    // 求解器与常规搜索共用停止标志：常规搜索结束时求解器随之中止，求解器证明必胜时
+    // 反过来结束常规搜索。所有线程先创建好再一起放行，创建线程本身的分配不计入
+    // result.allocations，此后求解与搜索都不应再有堆分配
+    std::atomic<bool> go{false};
+    auto waitForGo = [&go]() {
+        while(!go.load(std::memory_order_acquire)) std::this_thread::yield();
+    };
+    SolveResult solved;
+    std::thread solverThread;
+    if(solving) {
+        solverThread = std::thread([this, &pos, &solved, &waitForGo]() {
+            waitForGo();
+            solved = solver->solve(pos, &stopFlag, 0, tablebaseView());
+            if(solved.status == SolveStatus::Win) stopFlag.store(true);
+        });
+    }
+
+    // 辅助线程与主线程共享置换表；主线程结束后通知它们停止
+    std::vector<std::thread> helpers;
+    for(int i = 1; i < threadCount; ++i) {
+        ThreadData* td = threadData[i].get();
+        helpers.emplace_back([this, td, &pos, &waitForGo]() {
+            waitForGo();
+            iterativeDeepening(*td, pos);
+        });
+    }
+
+    const uint64_t allocsBefore = AllocCounter::allocations();
+    go.store(true, std::memory_order_release);
+    iterativeDeepening(*threadData[0], pos);
+    stopFlag.store(true);
+    for(auto& t : helpers) t.join();
+    if(solverThread.joinable()) solverThread.join();
+    result.allocations = AllocCounter::enabled() ? int64_t(AllocCounter::allocations() - allocsBefore) : -1;
+
+    // 选择结果：默认取主线程；若辅助线程完成了更深的迭代则采用它
+    const ThreadData* chosen = threadData[0].get();
+    uint64_t nodes = 0;
+    for(int i = 0; i < threadCount; ++i) {
+        const ThreadData* td = threadData[i].get();
+        nodes += td->nodes;
+        result.ordering += td->orderingStats;
+        if(td->completedDepth > chosen->completedDepth) chosen = td;
+    }
+
+    result.best = chosen->best;
+    result.score = chosen->bestScore;
+    result.depth = chosen->completedDepth;
+    result.nodes = nodes;
+    result.tt = tt.stats();
+    result.solved = solved.status;
+    result.solverNodes = solved.nodes;
+    if(solved.status == SolveStatus::Win) {
+        if(!solved.best.isNull()) result.best = solved.best;
+        result.score = std::max(result.score, DECIDED_SCORE);
+    } else if(solved.status == SolveStatus::Loss) {
+        result.score = std::min(result.score, -DECIDED_SCORE);
+    }
+    result.elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return toFullMove(result.best, result.score);
 }
@@ -1,6 +1,8 @@
 #include "startscreen.h"
 #include <QMessageBox>
 #include <QHeaderView>
+#include <QTimer>
+#include <QFile>
 
 StartScreen::StartScreen(QWidget *parent) : QWidget(parent) {
     setWindowTitle("Amazon Chess - Main Menu");
@@ -79,6 +81,37 @@ StartScreen::StartScreen(QWidget *parent) : QWidget(parent) {
     connect(btnLoadGame, &QPushButton::clicked, this, &StartScreen::onLoadGame);
 
     refreshSaveList();
+
+    // 上次运行遗留的对局日志说明对局异常中断，界面显示后询问是否恢复
+    QTimer::singleShot(0, this, &StartScreen::checkRecovery);
+}
+
+void StartScreen::checkRecovery() {
+    QDir dir("saves/journal");
+    if (!dir.exists()) return;
+    QFileInfoList list = dir.entryInfoList(QStringList() << "*.amzj", QDir::Files | QDir::NoSymLinks, QDir::Time);
+    if (list.isEmpty()) return;
+
+    // 只处理最近的一个
+    const QFileInfo &latest = list.first();
+    QMessageBox::StandardButton answer = QMessageBox::question(
+        this, "Recover Game",
+        "An interrupted game was found (" + latest.fileName() + ").\nDo you want to recover it?",
+        QMessageBox::Yes | QMessageBox::No);
+    if (answer != QMessageBox::Yes) {
+        QFile::remove(latest.absoluteFilePath());
+        return;
+    }
+
+    MainWindow *game = createGameWindow(false);
+    if (!game->recoverGame(latest.absoluteFilePath())) {
+        QMessageBox::critical(this, "Error", "Failed to recover the game.");
+        QFile::remove(latest.absoluteFilePath());
+        game->deleteLater();
+        return;
+    }
+    game->show();
+    this->hide();
 }
 
 void StartScreen::refreshSaveList() {
@@ -88,7 +121,7 @@ void StartScreen::refreshSaveList() {
         dir.mkpath(".");
     }
     
-    QFileInfoList list = dir.entryInfoList(QStringList() << "*.json", QDir::Files | QDir::NoSymLinks, QDir::Time);
+    QFileInfoList list = dir.entryInfoList(QStringList() << "*.amzb" << "*.json", QDir::Files | QDir::NoSymLinks, QDir::Time);
     for (const QFileInfo &info : list) {
         saveListWidget->addItem(info.fileName());
     }
@@ -112,7 +145,7 @@ void StartScreen::onLoadGame() {
     launchGame("saves/" + fileName, false); // Load assumes PvP for now, or save must store mode
 }
 
-void StartScreen::launchGame(const QString &savePath, bool vsAI) {
+MainWindow *StartScreen::createGameWindow(bool vsAI) {
     MainWindow *game = new MainWindow(nullptr, vsAI);
     
     // 监听游戏窗口关闭，重新显示主菜单
@@ -121,6 +154,11 @@ void StartScreen::launchGame(const QString &savePath, bool vsAI) {
         this->refreshSaveList();
         game->deleteLater();
     });
+    return game;
+}
+
+void StartScreen::launchGame(const QString &savePath, bool vsAI) {
+    MainWindow *game = createGameWindow(vsAI);
 
     if (!savePath.isEmpty()) {
         if (!game->loadGame(savePath)) {
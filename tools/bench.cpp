@@ -0,0 +1,192 @@
+// 端到端搜索基准：固定局面 × 固定深度 (或模拟次数)，输出总节点数、签名与 NPS
+//
+// 用法: bench [深度，默认 4] [-t 并行局面数] [--smp 每次搜索的线程数] [--mcts 模拟次数] [-H 置换表MB] [--solver]
+//
+// 每个局面用一个新建的引擎 (固定种子、关闭开局库，默认关闭残局求解器) 单线程搜索到给定深度，
+// 签名由各局面的节点数、最佳走法与分数依次混合得到。改动前后签名相同，说明搜索行为
+// 没有变化，NPS 的差异就是纯粹的性能差异。-t N 时先单线程跑一遍，再把局面分给 N 个
+// 线程并行跑一遍，两次签名必须一致 (不一致时返回 1)。--smp 让每次搜索使用 Lazy SMP，
+// 此时节点数每次运行都不同，签名只作参考。--solver 打开残局证明数求解器 (残局局面上
+// 与搜索并行运行，谁先结束取决于线程调度)，签名同样只作参考。
+//
+// Debug 构建 (AMAZONS_COUNT_ALLOCS) 中同时输出 Alpha-Beta 搜索期间的堆分配次数
+// (SearchResult::allocations，含辅助线程与求解器)；热路径必须不分配内存，非零即返回 1。
+
+#include "AllocCounter.h"
+#include "search_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 标准开局、自对弈中各阶段的局面，以及区域已分隔的残局
+const char* const POSITIONS[] = {
+    "2B2B2/8/B6B/8/8/R6R/8/2R2R2 r",
+    "2B2B2/6x1/1x2R3/5x2/2Bx1B2/R3R2R/8/5x2 b",
+    "4xB1x/x3R3/1B1R4/x3B3/2x1xR1x/x1x2B2/1x1R4/8 r",
+    "3x4/x2RB1x1/Bxx5/1x3x2/1x1x1B2/R2xR1Rx/1x2Bx2/3x1x2 b",
+    "4x1xx/xxB1x1x1/2R2x2/xx1RB1B1/2x1xRxx/xxx2B2/1x1R4/3x1x2 r",
+    "1Bx1x1R1/3xx3/x4xB1/xxBxB1x1/1Rxx1xxx/2xxRxRx/4x3/8 r",
+    "3xx3/xxxRBxx1/Bxx5/xx3xR1/1x1x1x1x/x1BxRBxx/Rxx2x2/3x1x2 b",
+    "2x1x1xx/xxRBx1x1/2xRxx2/xx2x1B1/2xxxRxx/xxxBx1B1/1xRx2x1/3xxxx1 r",
+    "x1x1x1BR/B2xxxxx/xBxBxxx1/xxxxxxx1/2xx1xxx/R1xx1xRx/2x1x3/2R5 b",
+    "1Rx1x1xx/xxxBx1x1/2xxxxB1/xx1RxRx1/2xxxxxx/xxxBxx2/1xRx2xB/3xxxx1 b",
+};
+const int POSITION_COUNT = int(sizeof(POSITIONS) / sizeof(POSITIONS[0]));
+
+struct Config {
+    int depth = 4;
+    int workers = 1;
+    int smpThreads = 1;
+    uint64_t mctsSimulations = 0;   // > 0 时使用 MCTS 后端
+    size_t hashMB = 16;
+    bool solver = false;
+};
+
+struct Entry {
+    uint64_t nodes = 0;
+    Move best = Move::none();
+    int score = 0;
+    int64_t allocations = -1;   // 只在 AMAZONS_COUNT_ALLOCS 构建的 Alpha-Beta 搜索中统计
+    uint64_t solverNodes = 0;
+};
+
+struct Run {
+    uint64_t nodes = 0;
+    uint64_t signature = 0;
+    double seconds = 0;
+    int64_t allocations = -1;
+    uint64_t solverNodes = 0;
+};
+
+uint64_t mix(uint64_t h, uint64_t v) {
+    h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 29);
+}
+
+Entry searchOne(const Config& cfg, const Position& pos) {
+    // 每个局面一个新引擎：置换表、历史表与随机数状态都从零开始，结果与执行顺序无关
+    SearchEngine engine;
+    engine.setHashSizeMB(cfg.hashMB);
+    engine.setBookEnabled(false);
+    engine.setSolverEnabled(cfg.solver);
+    engine.setThreads(cfg.smpThreads);
+    engine.setSeed(1);
+    SearchLimits limits;
+    if (cfg.mctsSimulations > 0) {
+        engine.setBackend(SearchBackend::Mcts);
+        limits.maxNodes = cfg.mctsSimulations;
+    } else {
+        limits.maxDepth = cfg.depth;
+    }
+    engine.getBestMove(pos, pos.sideToMove, limits);
+    const SearchResult& r = engine.lastResult();
+    return {r.nodes, r.best, r.score, r.allocations, r.solverNodes};
+}
+
+Run runAll(const Config& cfg, const std::vector<Position>& positions, int workers) {
+    std::vector<Entry> entries(positions.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < positions.size();)
+            entries[i] = searchOne(cfg, positions[i]);
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    Run run;
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    // 按局面顺序混合，与哪个线程搜索了哪个局面无关
+    for (const Entry& e : entries) {
+        run.nodes += e.nodes;
+        run.signature = mix(run.signature, e.nodes);
+        run.signature = mix(run.signature, uint64_t(uint8_t(e.best.from)) | uint64_t(uint8_t(e.best.to)) << 8
+                                               | uint64_t(uint8_t(e.best.arrow)) << 16);
+        run.signature = mix(run.signature, uint64_t(int64_t(e.score)));
+        run.solverNodes += e.solverNodes;
+        if (e.allocations >= 0) run.allocations = std::max<int64_t>(run.allocations, 0) + e.allocations;
+    }
+    return run;
+}
+
+void report(const char* label, const Run& run, bool solver) {
+    std::printf("%-10s nodes %llu  signature %016llx  time %.2f s  nps %.0f\n", label,
+                (unsigned long long)run.nodes, (unsigned long long)run.signature, run.seconds,
+                run.seconds > 0 ? run.nodes / run.seconds : 0.0);
+    if (solver) std::printf("%-10s solver nodes %llu\n", "", (unsigned long long)run.solverNodes);
+    if (run.allocations >= 0) std::printf("%-10s allocations during search %lld\n", "", (long long)run.allocations);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config cfg;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "-t") == 0 && i + 1 < argc) {
+            cfg.workers = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--smp") == 0 && i + 1 < argc) {
+            cfg.smpThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--mcts") == 0 && i + 1 < argc) {
+            cfg.mctsSimulations = uint64_t(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "-H") == 0 && i + 1 < argc) {
+            cfg.hashMB = size_t(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--solver") == 0) {
+            cfg.solver = true;
+        } else if (arg[0] != '-' && std::atoi(arg) > 0) {
+            cfg.depth = std::atoi(arg);
+        } else {
+            std::fprintf(stderr, "usage: %s [depth=4] [-t workers] [--smp threads] [--mcts simulations] [-H hash-mb] [--solver]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Position> positions(POSITION_COUNT);
+    for (int i = 0; i < POSITION_COUNT; ++i) {
+        if (!Position::fromString(POSITIONS[i], positions[i])) {
+            std::fprintf(stderr, "bad built-in position %d\n", i);
+            return 1;
+        }
+    }
+
+    if (cfg.mctsSimulations > 0)
+        std::printf("%d positions, mcts %llu simulations", POSITION_COUNT, (unsigned long long)cfg.mctsSimulations);
+    else
+        std::printf("%d positions, depth %d", POSITION_COUNT, cfg.depth);
+    std::printf(", search threads %d%s%s\n", cfg.smpThreads, cfg.solver ? ", solver on" : "",
+                cfg.smpThreads > 1 ? " (node counts are not reproducible)" : "");
+
+    // Alpha-Beta 搜索 (含 Lazy SMP 辅助线程与求解器) 的热路径不应有任何堆分配
+    const bool checkAllocs = AllocCounter::enabled() && cfg.mctsSimulations == 0;
+    Run single = runAll(cfg, positions, 1);
+    report("1 worker", single, cfg.solver);
+    if (checkAllocs && single.allocations != 0) {
+        std::printf("search allocated memory on the hot path\n");
+        return 1;
+    }
+    if (cfg.workers <= 1) return 0;
+
+    Run parallel = runAll(cfg, positions, cfg.workers);
+    char label[32];
+    std::snprintf(label, sizeof(label), "%d workers", cfg.workers);
+    report(label, parallel, cfg.solver);
+    if (parallel.signature != single.signature && cfg.smpThreads == 1 && !cfg.solver) {
+        std::printf("signature mismatch between single and parallel runs\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+// 开局库生成器 (.amzo)：引擎自对弈，汇总前若干回合的走法
+//
+// 用法: bookgen <输出文件> [对局数，默认 200] [收录回合数，默认 12] [每步毫秒，默认 100]
+//               [并行对局数，默认全部核心] [后端 mcts|ab，默认 mcts] [ab 的搜索线程数，默认 2]
+//
+// 每局从标准开局下到胜负已定 (无子可动或区域分隔后已能判定)。前 N 回合中每个 (局面, 走法)
+// 出现一次计 1 分，走这步的一方最终获胜再加 1 分；总分不足 2 (只出现一次且输了) 的走法不收录。
+// MCTS 后端每局使用不同的随机种子，对局自然分散；Alpha-Beta 后端单线程时是确定性的，
+// 每局都会是同一条变化，因此至少使用 2 个搜索线程，靠 Lazy SMP 的线程间扰动产生不同的对局。
+
+#include "OpeningBook.h"
+#include "Regions.h"
+#include "search_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct PlayedMove {
+    Position before;
+    Move move;
+};
+
+// 下完一局，返回胜方
+int playGame(SearchEngine& engine, int timeMs, std::vector<PlayedMove>& moves) {
+    moves.clear();
+    Position pos = Position::startPosition();
+    SearchLimits limits;
+    limits.timeMs = timeMs;
+    for (;;) {
+        int us = pos.sideToMove;
+        if (!pos.canMove(us)) return us ^ 1;
+        Regions::Outcome outcome = Regions::decide(pos, engine.tablebaseView());
+        if (outcome.decided) return outcome.winner;
+
+        engine.getBestMove(pos, us, limits);
+        Move m = engine.lastResult().best;
+        if (m.isNull() || !pos.isLegal(m)) return us ^ 1;
+        moves.push_back({pos, m});
+        pos.makeMove(m);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <output.amzo> [games=200] [plies=12] [ms-per-move=100] [workers] [mcts|ab] [ab-threads=2]\n",
+                     argv[0]);
+        return 2;
+    }
+    const std::string output = argv[1];
+    const int games = argc > 2 ? std::atoi(argv[2]) : 200;
+    const int plies = argc > 3 ? std::atoi(argv[3]) : 12;
+    const int timeMs = argc > 4 ? std::atoi(argv[4]) : 100;
+    int workers = argc > 5 ? std::atoi(argv[5]) : int(std::thread::hardware_concurrency());
+    const bool mcts = argc > 6 ? std::strcmp(argv[6], "ab") != 0 : true;
+    const int searchThreads = argc > 7 ? std::atoi(argv[7]) : 2;
+    if (games < 1 || plies < 1 || timeMs < 1) {
+        std::fprintf(stderr, "games, plies and ms-per-move must be positive\n");
+        return 2;
+    }
+    if (!mcts && searchThreads < 2) {
+        std::fprintf(stderr, "the ab backend needs at least 2 search threads, otherwise every game is the same line\n");
+        return 2;
+    }
+    workers = std::max(1, std::min(workers, games));
+
+    OpeningBook::Builder builder;
+    std::mutex builderMutex;
+    std::atomic<int> nextGame{0};
+    std::atomic<int> finished{0};
+    int wins[2] = {0, 0};
+
+    auto worker = [&]() {
+        SearchEngine engine;
+        engine.setHashSizeMB(8);
+        // 生成书时不能查旧书；残局求解器不影响开局，关掉以节省内存
+        engine.setBookEnabled(false);
+        engine.setSolverEnabled(false);
+        engine.loadTablebase("tablebase.amzt");
+        if (mcts) engine.setBackend(SearchBackend::Mcts);
+        else engine.setThreads(searchThreads);
+        std::vector<PlayedMove> moves;
+        for (int g; (g = nextGame.fetch_add(1)) < games;) {
+            engine.setSeed(0x9E3779B97F4A7C15ULL * uint64_t(g + 1));
+            int winner = playGame(engine, timeMs, moves);
+
+            std::lock_guard<std::mutex> lock(builderMutex);
+            for (size_t i = 0; i < moves.size() && int(i) < plies; ++i)
+                builder.add(moves[i].before, moves[i].move, moves[i].before.sideToMove == winner ? 2 : 1);
+            ++wins[winner];
+            int done = ++finished;
+            std::printf("game %d/%d: %zu plies, winner %s (%zu positions so far)\n", done, games,
+                        moves.size(), winner == 1 ? "red" : "blue", builder.positionCount());
+            std::fflush(stdout);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    // 只出现一次且输了的走法不收录
+    if (!builder.write(output, 2, uint32_t(plies))) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("red %d, blue %d; wrote %s\n", wins[1], wins[0], output.c_str());
+    return 0;
+}
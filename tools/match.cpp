@@ -0,0 +1,407 @@
+// 引擎对战：两种配置在所有核心上并行对弈，统计 Elo 差与误差范围，可按 SPRT 提前停止
+//
+// 用法: match <配置A> <配置B> [--games 最多对局数，默认 1000] [--concurrency 并行对局数，默认全部核心]
+//             [--openings 随机开局回合数，默认 4] [--seed 种子] [--sprt elo0 elo1 [alpha beta]]
+//             [--tb 残局库] [-o 棋谱文件]
+//
+// 配置是逗号分隔的 key=value，第一项可以直接写后端名：
+//     ab,ms=100            Alpha-Beta，每步 100 毫秒
+//     mcts,nodes=20000     MCTS，每步 20000 次模拟
+//     ab,depth=4,threads=2,hash=64,solver=0,book=0
+// 未给出 ms/nodes/depth 时每步 100 毫秒。开局库默认关闭，以免与随机开局冲突。
+//
+// 每个随机开局由两个引擎交换先后手各下一局。规则下不会和棋，胜率按二项分布估计 Elo 与
+// 95% 误差范围；SPRT 检验 H0: elo = elo0 对 H1: elo = elo1，对数似然比越过界限即停止派发
+// 新对局 (已开始的对局下完并计入)。棋谱为类 PGN 的文本，每局一段。
+//
+// 引擎在还能走棋时没有给出走法 (lastResult().best 为空) 视为引擎错误：在 stderr 报告，
+// 这局记为 "*" 且不计入胜负与 SPRT，停止派发新对局，最终返回 1。
+
+#include "Regions.h"
+#include "search_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Bitboards;
+
+namespace {
+
+struct EngineConfig {
+    std::string label;
+    SearchBackend backend = SearchBackend::AlphaBeta;
+    int timeMs = 0;
+    uint64_t nodes = 0;
+    int depth = 0;
+    int threads = 1;
+    size_t hashMB = 16;
+    bool solver = true;
+    bool book = false;
+    std::string bookPath = "book.amzo";
+};
+
+bool parseEngine(const std::string& text, EngineConfig& cfg) {
+    cfg.label = text;
+    std::stringstream ss(text);
+    std::string item;
+    bool first = true;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        std::string key = item.substr(0, eq);
+        std::string value = eq == std::string::npos ? std::string() : item.substr(eq + 1);
+        if (eq == std::string::npos && first) {
+            value = key;
+            key = "backend";
+        }
+        first = false;
+        if (key == "backend") {
+            if (value == "ab") cfg.backend = SearchBackend::AlphaBeta;
+            else if (value == "mcts") cfg.backend = SearchBackend::Mcts;
+            else if (value == "beam") cfg.backend = SearchBackend::Beam;
+            else return false;
+        } else if (key == "ms") {
+            cfg.timeMs = std::atoi(value.c_str());
+        } else if (key == "nodes") {
+            cfg.nodes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (key == "depth") {
+            cfg.depth = std::atoi(value.c_str());
+        } else if (key == "threads") {
+            cfg.threads = std::max(1, std::atoi(value.c_str()));
+        } else if (key == "hash") {
+            cfg.hashMB = size_t(std::max(1, std::atoi(value.c_str())));
+        } else if (key == "solver") {
+            cfg.solver = value != "0";
+        } else if (key == "book") {
+            cfg.book = value != "0";
+            if (cfg.book && value != "1") cfg.bookPath = value;
+        } else {
+            return false;
+        }
+    }
+    if (cfg.timeMs <= 0 && cfg.nodes == 0 && cfg.depth <= 0) cfg.timeMs = 100;
+    return true;
+}
+
+struct Player {
+    EngineConfig cfg;
+    SearchEngine engine;
+    SearchLimits limits;
+
+    void setup(const EngineConfig& c, const std::string& tablebasePath) {
+        cfg = c;
+        engine.setBackend(c.backend);
+        engine.setThreads(c.threads);
+        engine.setHashSizeMB(c.hashMB);
+        engine.setSolverEnabled(c.solver);
+        engine.setBookEnabled(c.book);
+        if (c.book) engine.loadBook(c.bookPath);
+        if (!tablebasePath.empty()) engine.loadTablebase(tablebasePath);
+        limits = SearchLimits();
+        if (c.timeMs > 0) limits.timeMs = c.timeMs;
+        if (c.nodes > 0) limits.maxNodes = c.nodes;
+        if (c.depth > 0) limits.maxDepth = c.depth;
+    }
+};
+
+struct GameRecord {
+    int index = 0;
+    bool aIsRed = true;
+    int openingPlies = 0;
+    std::vector<Move> moves;
+    int winner = -1;            // 1 红方，0 蓝方；-1 表示引擎出错，这局不计分
+    int faultySide = -1;        // 没有给出走法的一方
+    const char* termination = "";
+};
+
+std::string squareName(int sq) {
+    return std::string(1, char('a' + colOf(sq))) + char('1' + rowOf(sq));
+}
+
+std::string moveText(const Move& m) {
+    return squareName(m.from) + "-" + squareName(m.to) + "/" + squareName(m.arrow);
+}
+
+std::vector<Move> legalMoves(const Position& start) {
+    std::vector<Move> moves;
+    Position pos = start;
+    int us = pos.sideToMove;
+    Bitboard pieces = pos.amazons[us];
+    while (pieces) {
+        int from = popLsb(pieces);
+        Bitboard targets = pos.reachable(from);
+        while (targets) {
+            int to = popLsb(targets);
+            pos.moveAmazon(us, from, to);
+            Bitboard arrows = pos.reachable(to);
+            pos.moveAmazon(us, to, from);
+            while (arrows) moves.push_back({int8_t(from), int8_t(to), int8_t(popLsb(arrows))});
+        }
+    }
+    return moves;
+}
+
+// 同一个开局的两局使用同一个种子，保证交换先后手后开局相同
+std::vector<Move> randomOpening(uint64_t seed, int plies) {
+    std::mt19937_64 rng(seed);
+    std::vector<Move> line;
+    Position pos = Position::startPosition();
+    for (int i = 0; i < plies; ++i) {
+        std::vector<Move> moves = legalMoves(pos);
+        if (moves.empty()) break;
+        Move m = moves[rng() % moves.size()];
+        pos.makeMove(m);
+        line.push_back(m);
+    }
+    return line;
+}
+
+void playGame(Player& red, Player& blue, const std::vector<Move>& opening, uint64_t seed, GameRecord& rec) {
+    Position pos = Position::startPosition();
+    rec.moves.clear();
+    for (const Move& m : opening) {
+        pos.makeMove(m);
+        rec.moves.push_back(m);
+    }
+    rec.openingPlies = int(opening.size());
+    rec.winner = -1;
+    rec.faultySide = -1;
+
+    red.engine.clearHash();
+    blue.engine.clearHash();
+    red.engine.setSeed(seed);
+    blue.engine.setSeed(seed ^ 0x5DEECE66DULL);
+    for (;;) {
+        int us = pos.sideToMove;
+        if (!pos.canMove(us)) {
+            rec.winner = us ^ 1;
+            rec.termination = "no moves";
+            return;
+        }
+        Regions::Outcome outcome = Regions::decide(pos, red.engine.tablebaseView());
+        if (outcome.decided) {
+            rec.winner = outcome.winner;
+            rec.termination = "regions decided";
+            return;
+        }
+        Player& p = us == 1 ? red : blue;
+        p.engine.getBestMove(pos, us, p.limits);
+        Move m = p.engine.lastResult().best;
+        if (m.isNull()) {
+            // 还有棋可走却没有给出走法：这是引擎 (或后端) 的错误，不是一局正常的负局
+            rec.faultySide = us;
+            rec.termination = "engine error: no move";
+            return;
+        }
+        if (!pos.isLegal(m)) {
+            rec.winner = us ^ 1;
+            rec.termination = "illegal move";
+            return;
+        }
+        pos.makeMove(m);
+        rec.moves.push_back(m);
+    }
+}
+
+const char* resultText(const GameRecord& rec) {
+    return rec.winner == 1 ? "1-0" : rec.winner == 0 ? "0-1" : "*";
+}
+
+void writeGame(FILE* f, const GameRecord& rec, const EngineConfig& a, const EngineConfig& b) {
+    std::fprintf(f, "[Event \"match\"]\n[Game \"%d\"]\n[Red \"%s\"]\n[Blue \"%s\"]\n", rec.index + 1,
+                 (rec.aIsRed ? a : b).label.c_str(), (rec.aIsRed ? b : a).label.c_str());
+    std::fprintf(f, "[OpeningPlies \"%d\"]\n[Result \"%s\"]\n[Termination \"%s\"]\n\n", rec.openingPlies,
+                 resultText(rec), rec.termination);
+    std::string line;
+    for (size_t i = 0; i < rec.moves.size(); ++i) {
+        std::string token = (i % 2 == 0 ? std::to_string(i / 2 + 1) + ". " : std::string()) + moveText(rec.moves[i]);
+        if (line.size() + token.size() + 1 > 80) {
+            std::fprintf(f, "%s\n", line.c_str());
+            line.clear();
+        }
+        line += line.empty() ? token : " " + token;
+    }
+    line += line.empty() ? "" : " ";
+    std::fprintf(f, "%s%s\n\n", line.c_str(), resultText(rec));
+}
+
+double eloFromScore(double s) {
+    s = std::min(std::max(s, 1e-6), 1 - 1e-6);
+    return -400.0 * std::log10(1.0 / s - 1.0);
+}
+
+double scoreFromElo(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+
+// Elo 差与 95% 误差范围 (胜率的正态近似)；一方全胜时 Elo 无界
+std::string eloText(int wins, int losses) {
+    if (wins == 0 || losses == 0) return "elo n/a";
+    const int n = wins + losses;
+    const double s = double(wins) / n;
+    const double se = std::sqrt(s * (1 - s) / n);
+    const double margin = (eloFromScore(s + 1.96 * se) - eloFromScore(s - 1.96 * se)) / 2;
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "elo %+.1f +/- %.1f", eloFromScore(s), margin);
+    return buf;
+}
+
+struct Sprt {
+    bool enabled = false;
+    double elo0 = 0, elo1 = 5, alpha = 0.05, beta = 0.05;
+
+    // 无和棋时的二项似然比
+    double llr(int wins, int losses) const {
+        double p0 = scoreFromElo(elo0), p1 = scoreFromElo(elo1);
+        return wins * std::log(p1 / p0) + losses * std::log((1 - p1) / (1 - p0));
+    }
+    double lower() const { return std::log(beta / (1 - alpha)); }
+    double upper() const { return std::log((1 - beta) / alpha); }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <engineA> <engineB> [--games n] [--concurrency n] [--openings plies] [--seed s]\n"
+                             "          [--sprt elo0 elo1 [alpha beta]] [--tb tablebase.amzt] [-o games.pgn]\n"
+                             "engine: backend[,ms=..][,nodes=..][,depth=..][,threads=..][,hash=..][,solver=0|1][,book=0|1|path]\n",
+                     argv[0]);
+        return 2;
+    }
+    EngineConfig cfgA, cfgB;
+    if (!parseEngine(argv[1], cfgA) || !parseEngine(argv[2], cfgB)) {
+        std::fprintf(stderr, "bad engine configuration\n");
+        return 2;
+    }
+
+    int games = 1000;
+    int concurrency = int(std::max(1u, std::thread::hardware_concurrency()));
+    int openingPlies = 4;
+    uint64_t seed = 1;
+    Sprt sprt;
+    std::string tablebasePath = "tablebase.amzt";
+    const char* outPath = nullptr;
+    for (int i = 3; i < argc; ++i) {
+        const char* arg = argv[i];
+        auto next = [&]() { return i + 1 < argc ? argv[++i] : "0"; };
+        if (std::strcmp(arg, "--games") == 0) games = std::max(1, std::atoi(next()));
+        else if (std::strcmp(arg, "--concurrency") == 0) concurrency = std::max(1, std::atoi(next()));
+        else if (std::strcmp(arg, "--openings") == 0) openingPlies = std::max(0, std::atoi(next()));
+        else if (std::strcmp(arg, "--seed") == 0) seed = std::strtoull(next(), nullptr, 10);
+        else if (std::strcmp(arg, "--tb") == 0) tablebasePath = next();
+        else if (std::strcmp(arg, "-o") == 0) outPath = next();
+        else if (std::strcmp(arg, "--sprt") == 0) {
+            sprt.enabled = true;
+            sprt.elo0 = std::atof(next());
+            sprt.elo1 = std::atof(next());
+            if (i + 2 < argc && argv[i + 1][0] != '-') {
+                sprt.alpha = std::atof(next());
+                sprt.beta = std::atof(next());
+            }
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", arg);
+            return 2;
+        }
+    }
+    if (sprt.enabled && (sprt.elo1 <= sprt.elo0 || sprt.alpha <= 0 || sprt.beta <= 0)) {
+        std::fprintf(stderr, "--sprt needs elo0 < elo1 and positive alpha/beta\n");
+        return 2;
+    }
+    // 偶数局：每个开局两局
+    games += games % 2;
+    concurrency = std::min(concurrency, games);
+
+    FILE* out = nullptr;
+    if (outPath && !(out = std::fopen(outPath, "w"))) {
+        std::fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+    }
+
+    std::printf("A: %s\nB: %s\n%d games, %d concurrent, %d random opening plies\n", cfgA.label.c_str(),
+                cfgB.label.c_str(), games, concurrency, openingPlies);
+    if (sprt.enabled)
+        std::printf("SPRT elo0 %.1f elo1 %.1f alpha %.3f beta %.3f, bounds [%.2f, %.2f]\n", sprt.elo0, sprt.elo1,
+                    sprt.alpha, sprt.beta, sprt.lower(), sprt.upper());
+    std::fflush(stdout);
+
+    std::mutex statsMutex;
+    std::atomic<int> nextGame{0};
+    std::atomic<bool> stop{false};
+    int winsA = 0, winsB = 0, redWins = 0, engineErrors = 0;
+    const char* verdict = nullptr;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        Player a, b;
+        a.setup(cfgA, tablebasePath);
+        b.setup(cfgB, tablebasePath);
+        GameRecord rec;
+        for (int g; !stop.load() && (g = nextGame.fetch_add(1)) < games;) {
+            // 偶数局 A 执红，奇数局交换先后手，同一对使用相同的开局
+            const uint64_t pairSeed = seed * 0x9E3779B97F4A7C15ULL + uint64_t(g / 2);
+            const std::vector<Move> opening = randomOpening(pairSeed, openingPlies);
+            rec.index = g;
+            rec.aIsRed = g % 2 == 0;
+            playGame(rec.aIsRed ? a : b, rec.aIsRed ? b : a, opening, pairSeed, rec);
+
+            std::lock_guard<std::mutex> lock(statsMutex);
+            if (out) {
+                writeGame(out, rec, cfgA, cfgB);
+                std::fflush(out);
+            }
+            if (rec.winner == -1) {
+                // 配置或后端有问题，继续下去只会得到错误的 Elo：不计入统计，停止派发新对局
+                const bool aFaulty = (rec.faultySide == 1) == rec.aIsRed;
+                std::fprintf(stderr, "ERROR: game %d (ply %zu): engine %s \"%s\" returned no move\n", g + 1,
+                             rec.moves.size(), aFaulty ? "A" : "B", (aFaulty ? cfgA : cfgB).label.c_str());
+                std::fflush(stderr);
+                ++engineErrors;
+                stop = true;
+                continue;
+            }
+            const bool aWon = (rec.winner == 1) == rec.aIsRed;
+            (aWon ? winsA : winsB)++;
+            redWins += rec.winner == 1;
+
+            const int n = winsA + winsB;
+            const double minutes = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() / 60;
+            std::printf("game %d: A %d - %d B (red %d), %s, %.1f games/min", n, winsA, winsB, redWins,
+                        eloText(winsA, winsB).c_str(), minutes > 0 ? n / minutes : 0.0);
+            if (sprt.enabled) {
+                const double llr = sprt.llr(winsA, winsB);
+                std::printf(", LLR %.2f", llr);
+                if (!verdict && (llr >= sprt.upper() || llr <= sprt.lower())) {
+                    verdict = llr >= sprt.upper() ? "H1 accepted" : "H0 accepted";
+                    stop = true;
+                }
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < concurrency; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    if (out) std::fclose(out);
+
+    const int n = winsA + winsB;
+    const double minutes = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() / 60;
+    std::printf("finished %d games in %.1f min (%.1f games/min): A %d - %d B, score %.3f, %s\n", n, minutes,
+                minutes > 0 ? n / minutes : 0.0, winsA, winsB, n ? double(winsA) / n : 0.0,
+                eloText(winsA, winsB).c_str());
+    if (sprt.enabled) std::printf("SPRT: %s\n", verdict ? verdict : "inconclusive");
+    if (engineErrors) {
+        std::fprintf(stderr, "%d game(s) aborted by engine errors; results are incomplete\n", engineErrors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+// 规则、评估与存档热点路径的微基准
+//
+// 用法: microbench [--format json|csv] [--ms 每项最短计时毫秒，默认 200] [--repeat 重复次数，默认 5]
+//                  [--filter 名称子串] [-o 输出文件]
+//
+// 局面固定 (开局、中局、已分隔的残局，均用 Position::toString 格式写死)，长对局由固定种子的
+// 随机走子生成，因此不同构建之间的结果可以直接比较。每项重复若干轮取中位数，输出每次操作的
+// 纳秒数。AmazonEngine 与存档依赖 Qt Core，只在带 Qt 的构建中 (AMAZONS_BENCH_QT) 测量。
+
+#include "Evaluation.h"
+#include "GameLogic.h"
+#include "Territory.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef AMAZONS_BENCH_QT
+#include "AmazonEngine.h"
+#include "Regions.h"
+#include <filesystem>
+#include <random>
+#endif
+
+using namespace Bitboards;
+
+namespace {
+
+struct BenchPosition {
+    const char* name;
+    const char* text;
+};
+
+// 中局与残局取自引擎 (2 层搜索) 自对弈的第 20 与第 31 回合；残局已分隔但尚未判定
+const BenchPosition POSITIONS[] = {
+    {"opening", "2B2B2/8/B6B/8/8/R6R/8/2R2R2 r"},
+    {"middlegame", "1Bx1x1R1/3xx3/x4xB1/xxBxB1x1/1Rxx1xxx/2xxRxRx/4x3/8 r"},
+    {"endgame", "x1x1x1BR/B2xxxxx/xBxBxxx1/xxxxxxx1/2xx1xxx/R1xx1xRx/2x1x3/2R5 b"},
+};
+
+struct Result {
+    std::string name;
+    std::string position;
+    uint64_t opsPerRun = 0;     // 每轮计时内的操作次数
+    double nsPerOp = 0;         // 各轮的中位数
+    double minNsPerOp = 0;
+};
+
+struct Config {
+    int minMs = 200;
+    int repeat = 5;
+    std::string filter;
+};
+
+volatile uint64_t sink;         // 防止被测代码被优化掉
+
+double nowNs() {
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 反复调用 body (每次执行 opsPerCall 个操作) 直到一轮不短于 minMs，重复 repeat 轮
+Result measure(const Config& cfg, const std::string& name, const std::string& position,
+               uint64_t opsPerCall, const std::function<uint64_t()>& body) {
+    Result r;
+    r.name = name;
+    r.position = position;
+
+    // 先估计一次调用的耗时，确定每轮调用次数
+    uint64_t calls = 1;
+    for (;;) {
+        double t0 = nowNs();
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < calls; ++i) acc += body();
+        sink = acc;
+        double elapsed = nowNs() - t0;
+        if (elapsed >= cfg.minMs * 1e6 || calls >= (1ULL << 40)) break;
+        calls = elapsed < 1e3 ? calls * 16 : uint64_t(calls * cfg.minMs * 1.1e6 / elapsed) + 1;
+    }
+
+    std::vector<double> samples;
+    for (int k = 0; k < cfg.repeat; ++k) {
+        double t0 = nowNs();
+        uint64_t acc = 0;
+        for (uint64_t i = 0; i < calls; ++i) acc += body();
+        sink = acc;
+        samples.push_back((nowNs() - t0) / double(calls * opsPerCall));
+    }
+    std::sort(samples.begin(), samples.end());
+    r.opsPerRun = calls * opsPerCall;
+    r.nsPerOp = samples[samples.size() / 2];
+    r.minNsPerOp = samples.front();
+    return r;
+}
+
+void runRules(const Config& cfg, std::vector<Result>& out, const char* posName, const Position& pos) {
+    auto wanted = [&](const std::string& name) {
+        return cfg.filter.empty() || name.find(cfg.filter) != std::string::npos;
+    };
+
+    if (wanted("isPathClear")) {
+        // 所有同行、同列、同斜线的格子对
+        std::vector<std::pair<Point, Point>> pairs;
+        for (int a = 0; a < 64; ++a)
+            for (int b = 0; b < 64; ++b) {
+                Point pa = GameLogic::fromPosKey(a), pb = GameLogic::fromPosKey(b);
+                if (a != b && GameLogic::isLineMove(pa, pb)) pairs.push_back({pa, pb});
+            }
+        out.push_back(measure(cfg, "isPathClear", posName, pairs.size(), [&]() {
+            uint64_t n = 0;
+            for (const auto& p : pairs) n += GameLogic::isPathClear(p.first, p.second, pos);
+            return n;
+        }));
+    }
+    if (wanted("canPlayerMove")) {
+        out.push_back(measure(cfg, "canPlayerMove", posName, 2, [&]() {
+            return uint64_t(GameLogic::canPlayerMove(0, pos)) + GameLogic::canPlayerMove(1, pos);
+        }));
+    }
+    if (wanted("reachable")) {
+        // 原 getReachable：每个亚马逊的皇后可达格
+        int squares[8], n = 0;
+        for (Bitboard b = pos.amazons[0] | pos.amazons[1]; b;) squares[n++] = popLsb(b);
+        out.push_back(measure(cfg, "reachable", posName, n, [&]() {
+            uint64_t acc = 0;
+            for (int i = 0; i < n; ++i) acc += pos.reachable(squares[i]);
+            return acc;
+        }));
+    }
+    if (wanted("evaluate")) {
+        out.push_back(measure(cfg, "evaluate", posName, 1, [&]() {
+            return uint64_t(Evaluation::evaluate(pos, pos.sideToMove));
+        }));
+    }
+    if (wanted("territory")) {
+        out.push_back(measure(cfg, "territory", posName, 1, [&]() {
+            return uint64_t(Territory::evaluate(pos, pos.sideToMove));
+        }));
+    }
+}
+
+#ifdef AMAZONS_BENCH_QT
+
+// 固定种子的随机对局，下到胜负已定为止 (与 AmazonEngine 结束对局的条件一致)
+std::vector<Move> randomGame(uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Move> game;
+    Position pos = Position::startPosition();
+    std::vector<Move> moves;
+    for (;;) {
+        if (Regions::separated(pos) && Regions::decide(pos).decided) return game;
+        moves.clear();
+        int us = pos.sideToMove;
+        Bitboard pieces = pos.amazons[us];
+        while (pieces) {
+            int from = popLsb(pieces);
+            Bitboard targets = pos.reachable(from);
+            while (targets) {
+                int to = popLsb(targets);
+                pos.moveAmazon(us, from, to);
+                Bitboard arrows = pos.reachable(to);
+                pos.moveAmazon(us, to, from);
+                while (arrows) moves.push_back({int8_t(from), int8_t(to), int8_t(popLsb(arrows))});
+            }
+        }
+        if (moves.empty()) return game;
+        Move m = moves[rng() % moves.size()];
+        pos.makeMove(m);
+        game.push_back(m);
+    }
+}
+
+// AmazonEngine 的一局：从开局走完整局 (走子 + 射箭)；存档测的是终局时的整局记录
+void runEngine(const Config& cfg, std::vector<Result>& out, const std::vector<Move>& game) {
+    auto wanted = [&](const std::string& name) {
+        return cfg.filter.empty() || name.find(cfg.filter) != std::string::npos;
+    };
+    const std::string label = "game" + std::to_string(game.size());
+    auto play = [&](AmazonEngine& engine) {
+        uint64_t ok = 0;
+        for (const Move& m : game) {
+            ok += engine.movePiece(GameLogic::fromPosKey(m.from), GameLogic::fromPosKey(m.to)).success;
+            ok += engine.placeArrow(GameLogic::fromPosKey(m.arrow)).success;
+        }
+        return ok;
+    };
+
+    if (wanted("movePiece+placeArrow")) {
+        out.push_back(measure(cfg, "movePiece+placeArrow", label, game.size(), [&]() {
+            AmazonEngine engine;
+            return play(engine);
+        }));
+    }
+    if (wanted("undo+redo")) {
+        // 悔棋回到开局再重做到终局，两者都是增量日志上的 O(1) 操作
+        AmazonEngine engine;
+        play(engine);
+        out.push_back(measure(cfg, "undo+redo", label, 2 * game.size(), [&]() {
+            uint64_t n = 0;
+            while (engine.undo()) ++n;
+            while (engine.redo()) ++n;
+            return n;
+        }));
+    }
+
+    AmazonEngine engine;
+    play(engine);
+    const AmazonBoard board = engine.getBoard();
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    for (const char* ext : {".json", ".amzb"}) {
+        const QString path = QString::fromStdString((dir / ("amazons_microbench" + std::string(ext))).string());
+        const std::string suffix = std::string(ext + 1);
+        if (wanted("saveBoard." + suffix)) {
+            out.push_back(measure(cfg, "saveBoard." + suffix, label, 1, [&]() {
+                return uint64_t(AmazonPersistence::saveBoard(board, path));
+            }));
+        }
+        if (wanted("loadBoard." + suffix)) {
+            AmazonPersistence::saveBoard(board, path);
+            out.push_back(measure(cfg, "loadBoard." + suffix, label, 1, [&]() {
+                AmazonBoard loaded;
+                return uint64_t(AmazonPersistence::loadBoard(loaded, path));
+            }));
+        }
+        std::remove(path.toStdString().c_str());
+    }
+}
+
+#endif // AMAZONS_BENCH_QT
+
+void writeJson(FILE* f, const std::vector<Result>& results) {
+    std::fprintf(f, "{\n  \"simd\": \"%s\",\n  \"results\": [\n", Territory::simdLevelName(Territory::simdLevel()));
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(f, "    {\"name\": \"%s\", \"position\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.2f, \"min_ns_per_op\": %.2f}%s\n",
+                     r.name.c_str(), r.position.c_str(), (unsigned long long)r.opsPerRun, r.nsPerOp, r.minNsPerOp,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+}
+
+void writeCsv(FILE* f, const std::vector<Result>& results) {
+    std::fprintf(f, "name,position,ops,ns_per_op,min_ns_per_op\n");
+    for (const Result& r : results)
+        std::fprintf(f, "%s,%s,%llu,%.2f,%.2f\n", r.name.c_str(), r.position.c_str(),
+                     (unsigned long long)r.opsPerRun, r.nsPerOp, r.minNsPerOp);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config cfg;
+    bool csv = false;
+    const char* outPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--format") == 0 && i + 1 < argc) {
+            csv = std::strcmp(argv[++i], "csv") == 0;
+        } else if (std::strcmp(arg, "--ms") == 0 && i + 1 < argc) {
+            cfg.minMs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--repeat") == 0 && i + 1 < argc) {
+            cfg.repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--filter") == 0 && i + 1 < argc) {
+            cfg.filter = argv[++i];
+        } else if (std::strcmp(arg, "-o") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--format json|csv] [--ms min-ms] [--repeat n] [--filter name] [-o file]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    for (const BenchPosition& bp : POSITIONS) {
+        Position pos;
+        if (!Position::fromString(bp.text, pos)) {
+            std::fprintf(stderr, "bad built-in position %s\n", bp.name);
+            return 1;
+        }
+        runRules(cfg, results, bp.name, pos);
+    }
+#ifdef AMAZONS_BENCH_QT
+    // 取几个种子中最长的一局
+    std::vector<Move> game;
+    for (uint64_t seed = 1; seed <= 16; ++seed) {
+        std::vector<Move> g = randomGame(seed);
+        if (g.size() > game.size()) game.swap(g);
+    }
+    runEngine(cfg, results, game);
+#endif
+
+    FILE* f = outPath ? std::fopen(outPath, "w") : stdout;
+    if (!f) {
+        std::fprintf(stderr, "cannot write %s\n", outPath);
+        return 1;
+    }
+    if (csv) writeCsv(f, results);
+    else writeJson(f, results);
+    if (outPath) std::fclose(f);
+    return 0;
+}
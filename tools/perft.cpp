@@ -0,0 +1,58 @@
+// 走法生成的正确性与吞吐量基准
+//
+// 用法: perft [深度，默认 3] [-t 线程数] [-H 缓存MB] [-p "局面"] [-d]
+//
+// 局面使用 Position::toString 的格式，缺省为标准开局。-d 额外输出根节点每个走法的计数
+// (divide)，便于与其它实现逐项对比；-t/-H 只影响速度，计数必须与单线程一致。
+
+#include "Perft.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+int main(int argc, char** argv) {
+    int depth = 3;
+    Perft::Options options;
+    Position pos = Position::startPosition();
+    bool split = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "-t") == 0 && i + 1 < argc) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "-H") == 0 && i + 1 < argc) {
+            options.hashMB = size_t(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "-p") == 0 && i + 1 < argc) {
+            if (!Position::fromString(argv[++i], pos)) {
+                std::fprintf(stderr, "bad position: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "-d") == 0) {
+            split = true;
+        } else if (arg[0] != '-' && std::atoi(arg) > 0) {
+            depth = std::atoi(arg);
+        } else {
+            std::fprintf(stderr, "usage: %s [depth=3] [-t threads] [-H hash-mb] [-p \"position\"] [-d]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("position %s\n", pos.toString().c_str());
+    if (split) {
+        for (const auto& entry : Perft::divide(pos, depth)) {
+            const Move& m = entry.first;
+            std::printf("%d-%d/%d: %llu\n", m.from, m.to, m.arrow, (unsigned long long)entry.second);
+        }
+    }
+    for (int d = 1; d <= depth; ++d) {
+        Perft::Result r = Perft::run(pos, d, options);
+        // 不足 1 毫秒时速度没有意义，输出 n/a 而不是 0
+        char speed[32] = "n/a";
+        if (r.elapsedMs > 0) std::snprintf(speed, sizeof(speed), "%.0f", r.nodesPerSecond());
+        std::printf("perft %d: %llu nodes, %d ms, %s nodes/s\n", d, (unsigned long long)r.nodes, r.elapsedMs, speed);
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+// 孤立区域残局库生成器 (.amzt)，不依赖 Qt
+//
+// 用法: tbgen <输出文件> [最大空格数，默认 8] [线程数，默认全部核心]
+//
+// 按区域大小逐层做逆向动态规划：亚马逊每走一步 (走子 + 射箭) 区域恰好少一个空格，
+// 走完后只剩与亚马逊相邻的连通部分有用，因此 k 个空格的局面只依赖不超过 k - 1 个空格、
+// 已经算好的局面。每层的局面按规范化的键排序后切成分块，多个线程并行求解；
+// 每个分块完成后立即写入 <输出文件>.work/ 下的分块文件，中断后重新运行会跳过已完成的分块。
+
+#include "Tablebase.h"
+#include "Regions.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Bitboards;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t CHUNK_SIZE = 1 << 15;
+constexpr char CHUNK_MAGIC[4] = {'A', 'M', 'Z', 'C'};
+
+struct ChunkHeader {
+    char magic[4];
+    uint32_t level;
+    uint64_t count;
+};
+
+int shapeWidth(Bitboard s) {
+    Bitboard cols = s | s >> 32;
+    cols |= cols >> 16;
+    cols |= cols >> 8;
+    return msb(cols & 0xFF) + 1;
+}
+
+int shapeHeight(Bitboard s) { return rowOf(msb(s)) + 1; }
+
+Bitboard normalizeShape(Bitboard s) {
+    s >>= lsb(s) & ~7;
+    Bitboard cols = s | s >> 32;
+    cols |= cols >> 16;
+    cols |= cols >> 8;
+    return s >> lsb(cols & 0xFF);
+}
+
+// 所有王步连通、比 smaller 中形状多一格的形状 (平移到左下角，去重)
+std::vector<Bitboard> growShapes(const std::vector<Bitboard>& smaller) {
+    std::vector<Bitboard> out;
+    for (Bitboard s : smaller) {
+        int w = shapeWidth(s), h = shapeHeight(s);
+        // 形状贴着左下角，先整体右移/上移一格，才能向左/向下扩展
+        for (int dy = 0; dy <= (h < 8 ? 1 : 0); ++dy) {
+            for (int dx = 0; dx <= (w < 8 ? 1 : 0); ++dx) {
+                Bitboard moved = s << (dy * 8 + dx);
+                Bitboard frontier = kingSpread(moved) & ~moved;
+                while (frontier) out.push_back(normalizeShape(moved | squareBB(popLsb(frontier))));
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+// 一层的全部局面：每个形状的每个格子都可能是亚马逊
+std::vector<Tablebase::Key> levelKeys(const std::vector<Bitboard>& shapes) {
+    std::vector<Tablebase::Key> keys;
+    for (Bitboard s : shapes) {
+        Bitboard cells = s;
+        while (cells) {
+            int a = popLsb(cells);
+            keys.push_back(Tablebase::canonicalKey(s & ~squareBB(a), a));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+// 单个亚马逊在区域内最多能走的步数；更小的局面从 known 中查询
+int solve(const Tablebase::Key& key, const Tablebase::View& known) {
+    int amazon = key.amazon;
+    Bitboard area = key.cells & ~squareBB(amazon);
+    int upper = popCount(area);
+    int best = 0;
+    Bitboard targets = queenAttacks(amazon, ~area) & area;
+    while (targets) {
+        int to = popLsb(targets);
+        Bitboard afterMove = (area | squareBB(amazon)) & ~squareBB(to);
+        Bitboard arrows = queenAttacks(to, ~afterMove) & afterMove;
+        while (arrows) {
+            Bitboard rest = afterMove & ~squareBB(popLsb(arrows));
+            Bitboard reach = Regions::flood(kingAttacks(to) & rest, rest);
+            int next = known.probe(reach, to);
+            if (next < 0) {
+                std::fprintf(stderr, "internal error: missing smaller region\n");
+                std::exit(1);
+            }
+            best = std::max(best, 1 + next);
+            // 每步恰好占用一个空格，步数不可能超过空格数
+            if (best == upper) return best;
+        }
+    }
+    return best;
+}
+
+std::string chunkPath(const fs::path& dir, int level, size_t chunk) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "level%02d-%05zu.bin", level, chunk);
+    return (dir / name).string();
+}
+
+// 读取已完成的分块；不存在或不完整时返回 false
+bool loadChunk(const std::string& path, int level, size_t expected, std::vector<Tablebase::Entry>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    ChunkHeader h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+    if (std::memcmp(h.magic, CHUNK_MAGIC, sizeof(h.magic)) != 0 || h.level != uint32_t(level) || h.count != expected)
+        return false;
+    out.resize(expected);
+    return bool(in.read(reinterpret_cast<char*>(out.data()), std::streamsize(expected * sizeof(Tablebase::Entry))));
+}
+
+// 先写临时文件再改名，中断时不会留下半个分块
+bool writeFile(const std::string& path, const void* header, size_t headerSize, const void* data, size_t size) {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        if (headerSize) out.write(static_cast<const char*>(header), std::streamsize(headerSize));
+        out.write(static_cast<const char*>(data), std::streamsize(size));
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <output.amzt> [max-squares (1-%d, default 8)] [threads]\n",
+                     argv[0], Tablebase::MAX_SQUARES);
+        return 2;
+    }
+    const std::string output = argv[1];
+    int maxSquares = argc > 2 ? std::atoi(argv[2]) : 8;
+    if (maxSquares < 1 || maxSquares > Tablebase::MAX_SQUARES) {
+        std::fprintf(stderr, "max-squares must be between 1 and %d\n", Tablebase::MAX_SQUARES);
+        return 2;
+    }
+    int threads = argc > 3 ? std::atoi(argv[3]) : int(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+
+    const fs::path workDir = output + ".work";
+    std::error_code ec;
+    fs::create_directories(workDir, ec);
+    if (ec) {
+        std::fprintf(stderr, "cannot create %s\n", workDir.string().c_str());
+        return 1;
+    }
+
+    std::vector<Tablebase::Entry> all;
+    std::vector<uint8_t> image = Tablebase::encode(0, all);
+    Tablebase::View known;
+    known.open(image.data(), image.size());
+
+    std::vector<Bitboard> shapes = {1};     // 只有亚马逊一格
+    for (int level = 1; level <= maxSquares; ++level) {
+        shapes = growShapes(shapes);
+        const std::vector<Tablebase::Key> keys = levelKeys(shapes);
+        const size_t chunkCount = (keys.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        std::vector<std::vector<Tablebase::Entry>> results(chunkCount);
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> resumed{0};
+        std::atomic<bool> failed{false};
+
+        auto worker = [&]() {
+            for (size_t c; (c = nextChunk.fetch_add(1)) < chunkCount && !failed.load();) {
+                size_t begin = c * CHUNK_SIZE, end = std::min(keys.size(), begin + CHUNK_SIZE);
+                std::vector<Tablebase::Entry>& entries = results[c];
+                const std::string path = chunkPath(workDir, level, c);
+                if (loadChunk(path, level, end - begin, entries)) {
+                    ++resumed;
+                    continue;
+                }
+                entries.assign(end - begin, Tablebase::Entry());
+                for (size_t i = begin; i < end; ++i) {
+                    Tablebase::Entry& e = entries[i - begin];
+                    e.cells = keys[i].cells;
+                    e.amazon = keys[i].amazon;
+                    e.moves = uint8_t(solve(keys[i], known));
+                }
+                ChunkHeader h;
+                std::memcpy(h.magic, CHUNK_MAGIC, sizeof(h.magic));
+                h.level = uint32_t(level);
+                h.count = entries.size();
+                if (!writeFile(path, &h, sizeof(h), entries.data(), entries.size() * sizeof(Tablebase::Entry)))
+                    failed.store(true);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+        if (failed.load()) {
+            std::fprintf(stderr, "cannot write chunk files under %s\n", workDir.string().c_str());
+            return 1;
+        }
+
+        for (const auto& r : results) all.insert(all.end(), r.begin(), r.end());
+        image = Tablebase::encode(level, all);
+        known.open(image.data(), image.size());
+        std::printf("level %2d: %zu shapes, %zu positions (%zu/%zu chunks resumed), %zu total\n",
+                    level, shapes.size(), keys.size(), resumed.load(), chunkCount, all.size());
+        std::fflush(stdout);
+    }
+
+    if (!writeFile(output, nullptr, 0, image.data(), image.size())) {
+        std::fprintf(stderr, "cannot write %s\n", output.c_str());
+        return 1;
+    }
+    fs::remove_all(workDir, ec);
+    std::printf("wrote %s (%zu bytes)\n", output.c_str(), image.size());
+    return 0;
+}